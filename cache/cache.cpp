@@ -69,8 +69,9 @@ static void remote_set(const string &key, const string &value, redisContext *ctx
   freeReplyObject(reply);
 }
 
-static crc_t string_crc(const string &s) {
-  return crc_finalize(crc_update(crc_init(), s.data(), s.size()));
+static string string_crc(const string &s) {
+  return util::to_string(
+    crc128_finalize(crc128_update(crc128_init(), s.data(), s.size())));
 }
 
 bool Cache::lookup(const string &s) {
@@ -78,7 +79,7 @@ bool Cache::lookup(const string &s) {
   // Alive IR is bulky, so send a hash of it over to the cache. If
   // this still uses too much RAM, the next step will be to use a
   // Bloom filter
-  string remote_data, crc_string = to_string(string_crc(s));
+  string remote_data, crc_string = string_crc(s);
   if (remote_get(crc_string, remote_data, ctx)) {
     assert(remote_data == default_value);
     return true;
@@ -5,10 +5,12 @@
 #include "ir/attrs.h"
 #include "util/spaceship.h"
 #include "util/unionfind.h"
-#include <map>
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
-#define DEBUG_FMF
+// #define DEBUG_FMF
 
 #ifdef DEBUG_FMF
 # include <iostream>
@@ -19,12 +21,13 @@ using namespace smt;
 using namespace util;
 using namespace std;
 
-// Home-made e-graph to represent all possible fast-math reassociations
+// Home-made e-graph to represent all possible fast-math reassociations.
+// Follows the design of egg: nodes are hash-consed, e-classes are kept in a
+// union-find, and the congruence invariant is restored lazily by rebuild()
+// over a worklist of dirty classes rather than after every merge.
 
 namespace {
 
-class EGraph;
-
 struct Node {
   enum { Add, Sub, Mul, Div, Neg, Leaf } operation;
   unsigned op1 = -1u, op2 = -1u;
@@ -34,6 +37,24 @@ struct Node {
 
   auto operator<=>(const Node &other) const = default;
 
+  struct Hash {
+    size_t operator()(const Node &n) const {
+      size_t h = n.operation;
+      h = h * 31 + n.op1;
+      h = h * 31 + n.op2;
+      h = h * 31 + n.flags;
+      h = h * 31 + (n.leaf.isValid() ? n.leaf.id() : 0);
+      h = h * 31 + (n.rounding.isValid() ? n.rounding.id() : 0);
+      return h;
+    }
+  };
+
+  struct Eq {
+    bool operator()(const Node &a, const Node &b) const {
+      return is_eq(a <=> b);
+    }
+  };
+
 #ifdef DEBUG_FMF
   friend ostream& operator<<(ostream &os, const Node &n) {
     const char *op = nullptr;
@@ -64,49 +85,309 @@ struct Node {
 };
 
 
+struct EClass {
+  vector<Node> nodes;
+  vector<pair<Node, unsigned>> parents; // nodes that use this class & their id
+  expr witness; // an expression of this class; used to get the FP sort
+};
+
+}
+
+namespace IR {
+
 class EGraph {
-  UnionFind uf;                          // id -> root
-  map<Node, unsigned> nodes;             // node -> id
-  vector<vector<const Node*>> nodes_eqs; // root -> equiv nodes
-
-  unsigned get(Node &&n) {
-    auto [I, inserted] = nodes.try_emplace(std::move(n), 0);
-    if (inserted) {
-      I->second = uf.mk();
-      nodes_eqs.emplace_back(1, &I->first);
+  // Backoff scheduling (as in egg): a rule that matches too often in one
+  // iteration is banned for a while, so cheap rules such as commutativity
+  // can't starve the others or blow up the graph on their own.
+  enum Rule { Commute, Assoc, Distribute, Factor, Reciprocal, NumRules };
+
+  struct RuleState {
+    unsigned match_limit = 1000;
+    unsigned ban_length  = 5;
+    unsigned banned_until = 0;
+    unsigned times_banned = 0;
+  };
+
+  struct Match {
+    Rule rule;
+    unsigned eclass;
+    Node node;
+    Node other; // for nested patterns, the matched node in an operand class
+    unsigned extra = -1u; // any further operand class bound by the pattern
+  };
+
+  UnionFind uf;                                         // id -> root
+  unordered_map<Node, unsigned, Node::Hash, Node::Eq> memo; // node -> id
+  // AST id -> (expr, class id); keeps the expr alive so the id isn't reused
+  unordered_map<unsigned, pair<expr, unsigned>> expr_memo;
+  vector<EClass> classes;                               // id -> class
+  vector<unsigned> pending;                             // dirty classes
+  RuleState rules[NumRules];
+  unsigned max_iterations, max_nodes;                   // budget per query
+  size_t saturated_size = 0; // #nodes when last saturated
+
+  Node canonicalize(Node n) {
+    if (n.op1 != -1u)
+      n.op1 = root(n.op1);
+    if (n.op2 != -1u)
+      n.op2 = root(n.op2);
+    return n;
+  }
+
+  unsigned add(Node &&n0, const expr &witness) {
+    Node n = canonicalize(std::move(n0));
+    if (auto I = memo.find(n); I != memo.end())
+      return root(I->second);
+
+    unsigned id = uf.mk();
+    assert(id == classes.size());
+    auto &cls = classes.emplace_back();
+    cls.witness = witness;
+    cls.nodes.emplace_back(n);
+    if (n.op1 != -1u)
+      classes[n.op1].parents.emplace_back(n, id);
+    if (n.op2 != -1u && n.op2 != n.op1)
+      classes[n.op2].parents.emplace_back(n, id);
+    memo.emplace(std::move(n), id);
+    return id;
+  }
+
+  bool merge(unsigned a, unsigned b) {
+    a = root(a);
+    b = root(b);
+    if (a == b)
+      return false;
+
+    // keep the class with most parents as root to minimize repair work
+    if (classes[a].parents.size() < classes[b].parents.size())
+      swap(a, b);
+    ENSURE(uf.merge(b, a) == a);
+
+    auto &to   = classes[a];
+    auto &from = classes[b];
+    to.nodes.insert(to.nodes.end(), make_move_iterator(from.nodes.begin()),
+                    make_move_iterator(from.nodes.end()));
+    to.parents.insert(to.parents.end(),
+                      make_move_iterator(from.parents.begin()),
+                      make_move_iterator(from.parents.end()));
+    from = EClass();
+    pending.emplace_back(a);
+    return true;
+  }
+
+  // restore hash-consing & congruence for the users of a merged class
+  void repair(unsigned id) {
+    auto parents = std::move(classes[id].parents);
+    classes[id].parents.clear();
+
+    for (auto &[node, cls] : parents) {
+      memo.erase(node);
+      node = canonicalize(std::move(node));
+      memo.insert_or_assign(node, root(cls));
     }
-    return I->second;
+
+    // congruence: parents that became equal are merged
+    unordered_map<Node, unsigned, Node::Hash, Node::Eq> new_parents;
+    for (auto &[node, cls] : parents) {
+      auto [I, inserted]
+        = new_parents.try_emplace(canonicalize(node), root(cls));
+      if (!inserted) {
+        merge(I->second, cls);
+        I->second = root(cls);
+      }
+    }
+
+    auto &cls = classes[root(id)];
+    for (auto &[node, p] : new_parents) {
+      cls.parents.emplace_back(node, p);
+    }
+
+    auto &nodes = cls.nodes;
+    for (auto &n : nodes) {
+      n = canonicalize(std::move(n));
+    }
+    sort(nodes.begin(), nodes.end());
+    nodes.erase(unique(nodes.begin(), nodes.end(), Node::Eq()), nodes.end());
   }
 
-  void decl_equivalent(Node &&node, unsigned n1) {
-    unsigned n2 = get(std::move(node));
-    unsigned new_root = uf.merge(n2, n1);
-    auto &root = nodes_eqs[new_root];
+  void rebuild() {
+    while (!pending.empty()) {
+      auto todo = std::move(pending);
+      pending.clear();
+      for (auto &n : todo) {
+        n = root(n);
+      }
+      sort(todo.begin(), todo.end());
+      todo.erase(unique(todo.begin(), todo.end()), todo.end());
 
-    auto merge = [&](unsigned n) {
-      if (n != new_root) {
-        auto &prev = nodes_eqs[n];
-        root.insert(root.end(), prev.begin(), prev.end());
-        prev = vector<const Node*>();
+      for (auto n : todo) {
+        repair(n);
       }
-    };
-    merge(n1);
-    merge(n2);
+    }
   }
 
-  void remove(const Node &node) {
-    auto I = nodes.find(node);
-    assert(I != nodes.end());
-    erase(nodes_eqs[I->second], &node);
-    nodes.erase(I);
+  static bool sameOp(const Node &a, const Node &b) {
+    return a.operation == b.operation && a.rounding.eq(b.rounding);
+  }
+
+  static bool canDistribute(const Node &n) {
+    unsigned flags = FastMathFlags::Reassoc | FastMathFlags::NSZ;
+    return (n.flags & flags) == flags;
+  }
+
+  void search(Rule rule, vector<Match> &matches) {
+    for (unsigned id = 0, e = classes.size(); id != e; ++id) {
+      if (root(id) != id)
+        continue;
+
+      for (auto &node0 : classes[id].nodes) {
+        Node node = canonicalize(node0);
+        switch (rule) {
+        case Commute:
+          // x . y == y . x
+          // Always correct for add & mul regardless of fast-math
+          if ((node.operation == Node::Add || node.operation == Node::Mul) &&
+              node.op1 != node.op2)
+            matches.push_back({ rule, id, node, {}, -1u });
+          break;
+
+        case Assoc:
+          // (x . y) . z == x . (y . z)
+          if ((node.operation == Node::Add || node.operation == Node::Mul) &&
+              (node.flags & FastMathFlags::Reassoc)) {
+            for (auto &inner : classes[node.op1].nodes) {
+              if (sameOp(node, inner) &&
+                  (inner.flags & FastMathFlags::Reassoc))
+                matches.push_back({ rule, id, node, canonicalize(inner), -1u });
+            }
+          }
+          break;
+
+        case Distribute:
+          // x * (y +- z) == x * y +- x * z
+          // As in LLVM, this needs both reassoc and nsz
+          if (node.operation == Node::Mul && canDistribute(node)) {
+            for (auto &inner : classes[node.op2].nodes) {
+              if ((inner.operation == Node::Add ||
+                   inner.operation == Node::Sub) &&
+                  inner.rounding.eq(node.rounding) && canDistribute(inner))
+                matches.push_back({ rule, id, node, canonicalize(inner), -1u });
+            }
+          }
+          break;
+
+        case Factor:
+          // x * y +- x * z == x * (y +- z)
+          if ((node.operation == Node::Add || node.operation == Node::Sub) &&
+              canDistribute(node)) {
+            for (auto &lhs : classes[node.op1].nodes) {
+              if (lhs.operation != Node::Mul ||
+                  !lhs.rounding.eq(node.rounding) || !canDistribute(lhs))
+                continue;
+              for (auto &rhs : classes[node.op2].nodes) {
+                if (sameOp(lhs, rhs) && canDistribute(rhs) &&
+                    root(lhs.op1) == root(rhs.op1)) {
+                  matches.push_back({ rule, id, node, canonicalize(lhs),
+                                      root(rhs.op2) });
+                }
+              }
+            }
+          }
+          break;
+
+        case Reciprocal:
+          // x / y == x * (1 / y)
+          if (node.operation == Node::Div &&
+              (node.flags & FastMathFlags::ARCP))
+            matches.push_back({ rule, id, node, {}, -1u });
+          break;
+
+        case NumRules:
+          UNREACHABLE();
+        }
+      }
+    }
+  }
+
+  bool apply(const Match &m) {
+    auto &n = m.node;
+    auto witness = classes[root(m.eclass)].witness;
+    auto mk = [&](auto op, unsigned a, unsigned b) {
+      Node nn;
+      nn.operation = op;
+      nn.op1       = a;
+      nn.op2       = b;
+      nn.rounding  = n.rounding;
+      nn.flags     = n.flags;
+      return add(std::move(nn), witness);
+    };
+
+    unsigned equiv = -1u;
+    switch (m.rule) {
+    case Commute:
+      equiv = mk(n.operation, n.op2, n.op1);
+      break;
+
+    case Assoc:
+      equiv = mk(n.operation, m.other.op1,
+                 mk(n.operation, m.other.op2, n.op2));
+      break;
+
+    case Distribute:
+      equiv = mk(m.other.operation, mk(Node::Mul, n.op1, m.other.op1),
+                 mk(Node::Mul, n.op1, m.other.op2));
+      break;
+
+    case Factor:
+      equiv = mk(Node::Mul, m.other.op1,
+                 mk(n.operation, m.other.op2, m.extra));
+      break;
+
+    case Reciprocal: {
+      Node one;
+      one.operation = Node::Leaf;
+      one.leaf      = expr::mkFloat(1.0, witness);
+      unsigned one_id = add(std::move(one), witness);
+      if (root(n.op1) == root(one_id))
+        return false;
+      equiv = mk(Node::Mul, n.op1, mk(Node::Div, one_id, n.op2));
+      break;
+    }
+
+    case NumRules:
+      UNREACHABLE();
+    }
+    return merge(equiv, m.eclass);
   }
 
 public:
+  EGraph(unsigned max_iterations = 30, unsigned max_nodes = 10000)
+    : max_iterations(max_iterations), max_nodes(max_nodes) {}
+
   unsigned root(unsigned n) {
     return uf.find(n);
   }
 
   unsigned get(const expr &e0) {
+    // shared subterms are visited once
+    if (auto I = expr_memo.find(e0.id()); I != expr_memo.end())
+      return root(I->second.second);
+
+    unsigned id = get_(e0);
+    expr_memo.emplace(e0.id(), make_pair(e0, id));
+    return id;
+  }
+
+private:
+  // nsz is encoded as: ite(anyzero && isZero(v), -v, v)
+  static bool isAnyFPZero(const expr &e, expr &val) {
+    expr cond, neg, negv, var, is_zero;
+    return e.isIf(cond, neg, val) && neg.isFPNeg(negv) && negv.eq(val) &&
+           cond.isAnd(var, is_zero) && var.isVar() &&
+           var.fn_name().starts_with("anyzero") && is_zero.isIsFPZero();
+  }
+
+  unsigned get_(const expr &e0) {
     Node n;
     expr rounding, a, b;
     bool is_leaf = false;
@@ -128,12 +409,21 @@ public:
         n.operation = Node::Div;
       } else if (e.isFPNeg(a)) {
         n.operation = Node::Neg;
+      } else if (isAnyFPZero(e, a)) {
+        n.flags |= FastMathFlags::NSZ;
+        e = std::move(a);
+        continue;
       } else if (auto name = e.fn_name(); !name.empty()) {
         if (name == "reassoc") {
           n.flags |= FastMathFlags::Reassoc;
           e = e.getFnArg(0);
           continue;
         }
+        if (name == "arcp") {
+          n.flags |= FastMathFlags::ARCP;
+          e = e.getFnArg(0);
+          continue;
+        }
         is_leaf = true;
       } else {
         is_leaf = true;
@@ -147,147 +437,77 @@ public:
         n.rounding = std::move(rounding);
       }
 
-      return get(std::move(n));
+      return add(std::move(n), e0);
     }
   }
 
+public:
+  // Equality saturation with deferred rebuilding: each iteration first
+  // collects the matches of all rules over a congruent graph, then applies
+  // them all, and only then restores the invariants.
   void saturate() {
-    while (true) {
-      auto nodes_copy = nodes;
-      bool changed = false;
+    // only new terms can trigger new rewrites
+    if (memo.size() == saturated_size)
+      return;
+
+    // The graph is shared by all the refinement checks of a function; each
+    // one gets the same budget regardless of what the previous ones added.
+    // Bans are relative to the iteration number, so they restart as well.
+    size_t node_limit = memo.size() + max_nodes;
+    for (auto &rule : rules) {
+      rule = RuleState();
+    }
 
-      for (auto &[node, n] : nodes_copy) {
-        // canonicalize operand ids
-        if ((node.op1 != -1u && node.op1 != root(node.op1)) ||
-            (node.op2 != -1u && node.op2 != root(node.op2))) {
-          Node nn = node;
-          nn.op1 = root(node.op1);
-          if (node.op2 != -1u)
-            nn.op2 = root(node.op2);
-          assert(is_neq(node <=> nn));
-
-          decl_equivalent(std::move(nn), n);
-          remove(node);
-          changed = true;
-          continue;
-        }
+    for (unsigned iter = 0; iter < max_iterations; ++iter) {
+      vector<Match> matches;
+      bool any_banned = false;
 
-        // commutativity: x . y == y . x
-        // Always correct for add & mul regardless of fast-math
-        if (node.operation == Node::Add || node.operation == Node::Mul) {
-          Node nn = node;
-          swap(nn.op1, nn.op2);
-          decl_equivalent(std::move(nn), n);
+      for (unsigned r = 0; r < NumRules; ++r) {
+        auto &rule = rules[r];
+        if (rule.banned_until > iter) {
+          any_banned = true;
+          continue;
         }
 
-        if (node.flags & FastMathFlags::Reassoc) {
-          // distributivity: x . (y + z) == x . y + x . z
-          // TODO
-
-          // associativity (x . y) . z == x . (y . z)
-          // TODO
-
-        }
+        auto size = matches.size();
+        search(Rule(r), matches);
 
-        if (node.flags & FastMathFlags::Contract) {
-          // x / y == x * (1 / y)
-          // TODO
+        if (matches.size() - size > (rule.match_limit << rule.times_banned)) {
+          rule.banned_until = iter + (rule.ban_length << rule.times_banned);
+          ++rule.times_banned;
+          matches.resize(size);
+          any_banned = true;
         }
       }
 
-      if (!changed && nodes.size() == nodes_copy.size())
-        return;
-    }
-  }
-
-  expr smtOf(unsigned n) {
-    vector<optional<expr>> exprs;  // map node id -> smt expr
-    exprs.resize(nodes_eqs.size());
-    vector<unsigned> todo = { n };
-
-    do {
-      unsigned node_id = todo.back();
-      if (exprs[node_id]) {
-        todo.pop_back();
-        continue;
-      }
-
-      ChoiceExpr<expr> vals;
-      bool has_all = true;
-
-      for (auto *node : nodes_eqs[node_id]) {
-        switch (node->operation) {
-        case Node::Add:
-        case Node::Sub:
-        case Node::Mul:
-        case Node::Div:
-          if (!exprs[node->op2]) {
-            todo.emplace_back(node->op2);
-            has_all = false;
-          }
-          [[fallthrough]];
-
-        case Node::Neg:
-          if (!exprs[node->op1]) {
-            todo.emplace_back(node->op1);
-            has_all = false;
-          }
-          break;
-
-        case Node::Leaf:
-          break;
-        }
-
-        if (!has_all)
-          continue;
-
-        // TODO: handle other fastmath flags like nsz
-        expr val;
-        switch (node->operation) {
-        case Node::Add:
-          val = exprs[node->op1]->fadd(*exprs[node->op2], node->rounding);
-          break;
-        case Node::Sub:
-          val = exprs[node->op1]->fsub(*exprs[node->op2], node->rounding);
-          break;
-        case Node::Mul:
-          val = exprs[node->op1]->fmul(*exprs[node->op2], node->rounding);
-          break;
-        case Node::Div:
-          val = exprs[node->op1]->fdiv(*exprs[node->op2], node->rounding);
-          break;
-        case Node::Neg:
-          val = exprs[node->op1]->fneg();
+      bool changed = false;
+      auto num_nodes = memo.size();
+      for (auto &m : matches) {
+        changed |= apply(m);
+        if (memo.size() > node_limit)
           break;
-        case Node::Leaf:
-          val = node->leaf;
-        }
-        vals.add(std::move(val), expr(true));
       }
+      changed |= memo.size() != num_nodes;
+      rebuild();
 
-      if (!has_all)
-        continue;
+      if (memo.size() > node_limit)
+        break;
 
-      auto [val, domain, qvar, pre] = std::move(vals)();
-      assert(domain.isTrue());
-      exprs[node_id] = std::move(val);
-      // TODO: handle qvar, pre
-      todo.pop_back();
-
-    } while (!todo.empty());
-
-    assert(exprs.size() >= n && exprs[n]);
-    return std::move(*exprs[n]);
+      // fully saturated
+      if (!changed && !any_banned)
+        break;
+    }
+    saturated_size = memo.size();
   }
 
 #ifdef DEBUG_FMF
   friend ostream& operator<<(ostream &os, const EGraph &g) {
-    for (unsigned i = 0, e = g.nodes_eqs.size(); i != e; ++i) {
-      auto &nodes = g.nodes_eqs[i];
+    for (unsigned i = 0, e = g.classes.size(); i != e; ++i) {
+      auto &nodes = g.classes[i].nodes;
       if (!nodes.empty()) {
         os << "Root " << i << '\n';
-        for (auto *n : nodes) {
-          os << "  " << *n << '\n';
+        for (auto &n : nodes) {
+          os << "  " << n << '\n';
         }
       }
     }
@@ -296,36 +516,61 @@ public:
 #endif
 };
 
+
+FastMathEGraph::FastMathEGraph() : g(make_unique<EGraph>()) {}
+
+FastMathEGraph::~FastMathEGraph() {}
+
+// Returns true if e has a value computed with reassoc or arcp, i.e., if
+// there's anything for the e-graph rewrites to work with.
+static bool has_fast_math_rewrites(const expr &e) {
+  vector<expr> todo = { e };
+  unordered_set<unsigned> seen;
+  do {
+    auto v = std::move(todo.back());
+    todo.pop_back();
+    if (v.isConst() || !seen.emplace(v.id()).second)
+      continue;
+
+    auto name = v.fn_name();
+    if (name.empty()) // not an application, e.g., a quantifier
+      continue;
+    if (name == "reassoc" || name == "arcp")
+      return true;
+
+    for (unsigned i = 0, e = v.getFnNumArgs(); i != e; ++i) {
+      todo.emplace_back(v.getFnArg(i));
+    }
+  } while (!todo.empty());
+  return false;
 }
 
-namespace IR {
+expr FastMathEGraph::refined(const expr &a, const expr &b) {
+  if (!has_fast_math_rewrites(a) && !has_fast_math_rewrites(b))
+    return a == b;
 
-expr float_refined(const expr &a, const expr &b) {
-  EGraph g;
-  unsigned na = g.get(a);
-  unsigned nb = g.get(b);
+  unsigned na = g->get(a);
+  unsigned nb = g->get(b);
 #ifdef DEBUG_FMF
-  cout << "Before saturate:\n" << g << "Roots: " << na << " / " << nb << "\n\n";
+  cout << "Before saturate:\n" << *g << "Roots: " << na << " / " << nb
+       << "\n\n";
 #endif
 
-  if (na == nb)
+  if (g->root(na) == g->root(nb))
     return true;
 
-  g.saturate();
+  g->saturate();
 
-  na = g.root(na);
-  nb = g.root(nb);
+  na = g->root(na);
+  nb = g->root(nb);
 #ifdef DEBUG_FMF
-  cout << "After saturate:\n" << g << "Roots: " << na << " / " << nb << "\n\n";
+  cout << "After saturate:\n" << *g << "Roots: " << na << " / " << nb << "\n\n";
 #endif
   if (na == nb)
     return true;
 
-#ifdef DEBUG_FMF
-  cout << "Expr A: " << g.smtOf(na) << "\n\nExpr B: " << g.smtOf(nb) << "\n\n";
-#endif
-
-  return g.smtOf(na) == g.smtOf(nb);
+  // not provably equal structurally; give the solver the original values
+  return a == b;
 }
 
 }
@@ -4,9 +4,23 @@
 // Distributed under the MIT license that can be found in the LICENSE file.
 
 #include "smt/expr.h"
+#include <memory>
 
 namespace IR {
 
-smt::expr float_refined(const smt::expr &a, const smt::expr &b);
+class EGraph;
+
+// An e-graph shared by the source and target programs. FP values of both are
+// added to the same graph, so values that are equal modulo the allowed
+// fast-math rewrites end up in the same e-class and need no SMT reasoning.
+class FastMathEGraph {
+  std::unique_ptr<EGraph> g;
+
+public:
+  FastMathEGraph();
+  ~FastMathEGraph();
+
+  smt::expr refined(const smt::expr &a, const smt::expr &b);
+};
 
 }
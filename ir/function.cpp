@@ -125,6 +125,22 @@ expr Function::getTypeConstraints() const {
   return t;
 }
 
+bool Function::hasConcreteTypes() const {
+  if (!getType().isConcrete())
+    return false;
+  for (auto &i : instrs()) {
+    if (!i.getType().isConcrete())
+      return false;
+  }
+  for (auto &l : { getConstants(), getInputs(), getUndefs() }) {
+    for (auto &v : l) {
+      if (!v.getType().isConcrete())
+        return false;
+    }
+  }
+  return true;
+}
+
 void Function::fixupTypes(const Model &m) {
   for (auto bb : getBBs()) {
     bb->fixupTypes(m);
@@ -68,6 +68,8 @@ class Function final {
   unsigned bits_ptr_offset = 64;
   bool little_endian = true;
   bool is_var_args = false;
+  // set by front-ends that only produce well-typed code (e.g., from LLVM)
+  bool well_typed = false;
 
   // constants used in this function
   std::vector<std::unique_ptr<Value>> constants;
@@ -100,6 +102,11 @@ public:
 
   smt::expr getTypeConstraints() const;
   void fixupTypes(const smt::Model &m);
+  // true if all values have concrete types, i.e., there is a single typing
+  bool hasConcreteTypes() const;
+
+  bool isWellTyped() const { return well_typed; }
+  void setWellTyped() { well_typed = true; }
 
   const BasicBlock& getFirstBB() const { return *BB_order[0]; }
   BasicBlock& getFirstBB() { return *BB_order[0]; }
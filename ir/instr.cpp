@@ -55,31 +55,45 @@ struct LoopLikeFunctionApproximator {
 
   LoopLikeFunctionApproximator(fn_t ith_exec) : ith_exec(std::move(ith_exec)) {}
 
+  // If the number of iterations is bounded by this, unroll it fully
+  static constexpr uint64_t max_exact_iters = 64;
+
   // (value, nonpoison, UB)
-  tuple<expr, expr, expr> encode(IR::State &s, unsigned unroll_cnt) {
+  // max_iters is the number of iterations after which continuing is UB, if
+  // known. Otherwise, unrolling stops after unroll_cnt symbolic iterations,
+  // and the remaining ones are assumed not to execute.
+  tuple<expr, expr, expr> encode(IR::State &s, unsigned unroll_cnt,
+                                 uint64_t max_iters = UINT64_MAX) {
+    max_iters = max(max_iters, (uint64_t)1);
+    if (max_iters <= max_exact_iters)
+      unroll_cnt = max_iters;
     AndExpr prefix;
-    return _loop(s, prefix, 0, unroll_cnt);
+    return _loop(s, prefix, 0, unroll_cnt, max_iters);
   }
 
   // (value, nonpoison, UB)
   tuple<expr, expr, expr> _loop(IR::State &s, AndExpr &prefix, unsigned i,
-                                unsigned unroll_cnt) {
-    bool is_last = i >= unroll_cnt - 1;
+                                unsigned unroll_cnt, uint64_t max_iters) {
+    bool is_bound = i >= max_iters - 1;
+    bool is_last = is_bound || i >= unroll_cnt - 1;
     auto [res_i, np_i, ub_i, continue_i] = ith_exec(i, is_last);
     auto ub = ub_i();
     prefix.add(ub_i);
 
     // Keep going if the function is being applied to a constant input
-    is_last &= !continue_i.isConst();
+    is_last = is_bound || (is_last && !continue_i.isConst());
 
-    if (is_last)
+    if (is_bound)
+      ub &= !continue_i;
+    else if (is_last)
       s.addPre(prefix().implies(!continue_i));
 
     if (is_last || continue_i.isFalse() || ub.isFalse() || !s.isViablePath())
       return { std::move(res_i), std::move(np_i), std::move(ub) };
 
     prefix.add(continue_i);
-    auto [val_next, np_next, ub_next] = _loop(s, prefix, i + 1, unroll_cnt);
+    auto [val_next, np_next, ub_next]
+      = _loop(s, prefix, i + 1, unroll_cnt, max_iters);
     return { expr::mkIf(continue_i, std::move(val_next), std::move(res_i)),
              np_i && continue_i.implies(np_next),
              ub && continue_i.implies(ub_next) };
@@ -94,6 +108,35 @@ uint64_t getGlobalVarSize(const IR::Value *V) {
   return UINT64_MAX;
 }
 
+// Returns the number of bytes that can be read from the given pointer before
+// going out of bounds, if it points to a global or alloca at a known offset.
+uint64_t getReadableBytes(const IR::Value *V) {
+  uint64_t offset = 0;
+  while (true) {
+    if (auto *V2 = isNoOp(*V)) {
+      V = V2;
+    } else if (auto gep = dynamic_cast<const IR::GEP*>(V)) {
+      for (auto &[mul, idx] : gep->getIdxs()) {
+        auto n = IR::getInt(*idx);
+        if (!n || *n < 0)
+          return UINT64_MAX;
+        offset = add_saturate(offset, mul_saturate(mul, *n));
+      }
+      V = &gep->getPtr();
+    } else {
+      break;
+    }
+  }
+
+  uint64_t size = getGlobalVarSize(V);
+  if (auto alloc = dynamic_cast<const IR::Alloc*>(V))
+    size = alloc->getMaxAllocSize().first;
+
+  if (size == UINT64_MAX)
+    return UINT64_MAX;
+  return size > offset ? size - offset : 0;
+}
+
 }
 
 
@@ -3861,8 +3904,15 @@ StateValue Memcmp::toSMT(State &s) const {
              std::move(np), {},
              val_eq && vnum.uge(i + 2) };
   };
+  // reading past either buffer is UB
+  auto max_iters = min(getReadableBytes(ptr1), getReadableBytes(ptr2));
+  if (auto n = getInt(*num))
+    max_iters = min(max_iters, (uint64_t)*n);
+
   auto [val, np, ub]
-    = LoopLikeFunctionApproximator(ith_exec).encode(s, memcmp_unroll_cnt);
+    = LoopLikeFunctionApproximator(ith_exec).encode(s, memcmp_unroll_cnt,
+                                                    max_iters);
+  s.addUB((vnum != 0).implies(ub));
   return { expr::mkIf(vnum == 0, zero, std::move(val)), (vnum != 0).implies(np) };
 }
 
@@ -3917,7 +3967,8 @@ StateValue Strlen::toSMT(State &s) const {
     return { expr::mkUInt(i, ty.bits()), true, std::move(ub), val.value != 0 };
   };
   auto [val, _, ub]
-    = LoopLikeFunctionApproximator(ith_exec).encode(s, strlen_unroll_cnt);
+    = LoopLikeFunctionApproximator(ith_exec).encode(s, strlen_unroll_cnt,
+                                                    getReadableBytes(ptr));
   s.addUB(std::move(ub));
   return { std::move(val), true };
 }
@@ -4942,7 +4993,13 @@ const ConversionOp* isCast(ConversionOp::Op op, const Value &v) {
 }
 
 bool hasNoSideEffects(const Instr &i) {
+  // division by zero is UB
+  if (auto *bop = dynamic_cast<const BinOp*>(&i))
+    return !bop->isDivOrRem();
+
   return isNoOp(i) ||
+         dynamic_cast<const UnaryOp*>(&i) ||
+         dynamic_cast<const Select*>(&i) ||
          dynamic_cast<const ConversionOp*>(&i) ||
          dynamic_cast<const ExtractValue*>(&i) ||
          dynamic_cast<const Freeze*>(&i) ||
@@ -40,12 +40,17 @@ private:
   Value *lhs, *rhs;
   Op op;
   unsigned flags;
-  bool isDivOrRem() const;
 
 public:
   BinOp(Type &type, std::string &&name, Value &lhs, Value &rhs, Op op,
         unsigned flags = None);
 
+  Value& getLHS() const { return *lhs; }
+  Value& getRHS() const { return *rhs; }
+  Op getOp() const { return op; }
+  unsigned getFlags() const { return flags; }
+  bool isDivOrRem() const;
+
   std::vector<Value*> operands() const override;
   bool propagatesPoison() const override;
   void rauw(const Value &what, Value &with) override;
@@ -308,6 +313,7 @@ public:
 
   Value *getTrueValue() const { return a; }
   Value *getFalseValue() const { return b; }
+  const FastMathFlags& getFastMathFlags() const { return fmath; }
 
   std::vector<Value*> operands() const override;
   void rauw(const Value &what, Value &with) override;
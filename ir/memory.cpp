@@ -125,6 +125,48 @@ static unsigned padding_nonptr_byte() {
     Byte::bitsByte() - does_ptr_mem_access - bits_byte - bits_poison_per_byte;
 }
 
+// int-only blocks are only worth it if bytes may hold both ints and ptrs
+static bool has_int_only_blocks() {
+  return byte_has_ptr_bit();
+}
+
+static unsigned bits_int_byte() {
+  return bits_poison_per_byte + bits_byte;
+}
+
+static expr to_int_byte(const expr &byte) {
+  auto start = padding_nonptr_byte();
+  return byte.extract(start + bits_int_byte() - 1, start);
+}
+
+static expr from_int_byte(const expr &byte) {
+  return expr::mkUInt(0, 1).concat(byte).concat_zeros(padding_nonptr_byte());
+}
+
+static expr widen_int_array(const expr &array) {
+  expr val, arr, idx, cond, then, els;
+  if (array.isConstArray(val))
+    return expr::mkConstArray(expr::mkUInt(0, Pointer::bitsShortOffset()),
+                              from_int_byte(val));
+  if (array.isStore(arr, idx, val))
+    return widen_int_array(arr).store(idx, from_int_byte(val));
+  if (array.isIf(cond, then, els))
+    return expr::mkIf(cond, widen_int_array(then), widen_int_array(els));
+
+  auto offset
+    = expr::mkFreshVar("#off", expr::mkUInt(0, Pointer::bitsShortOffset()));
+  return expr::mkLambda(offset, from_int_byte(array.load(offset)));
+}
+
+static bool all_int_bytes(const Memory &m,
+                          const vector<pair<unsigned, expr>> &data) {
+  for (auto &[idx, val] : data) {
+    if (!Byte(m, expr(val)).isPtr().isFalse())
+      return false;
+  }
+  return true;
+}
+
 static expr concat_if(const expr &ifvalid, expr &&e) {
   return ifvalid.isValid() ? ifvalid.concat(e) : std::move(e);
 }
@@ -693,13 +735,30 @@ void Memory::AliasSet::print(ostream &os) const {
     os << "(empty)";
 }
 
+expr Memory::MemBlock::load(const expr &offset) const {
+  auto byte = val.load(offset);
+  return int_only ? from_int_byte(byte) : byte;
+}
+
+expr Memory::MemBlock::repr(const expr &byte) const {
+  return int_only ? to_int_byte(byte) : byte;
+}
+
+void Memory::MemBlock::widen() {
+  if (int_only) {
+    val = widen_int_array(val);
+    int_only = false;
+  }
+}
+
 weak_ordering Memory::MemBlock::operator<=>(const MemBlock &rhs) const {
   // FIXME:
   // 1) xcode doesn't have tuple::operator<=>
   // 2) gcc has a bug and can't generate the default
-  if (auto cmp = val   <=> rhs.val;   is_neq(cmp)) return cmp;
-  if (auto cmp = undef <=> rhs.undef; is_neq(cmp)) return cmp;
-  if (auto cmp = type  <=> rhs.type;  is_neq(cmp)) return cmp;
+  if (auto cmp = val      <=> rhs.val;      is_neq(cmp)) return cmp;
+  if (auto cmp = undef    <=> rhs.undef;    is_neq(cmp)) return cmp;
+  if (auto cmp = type     <=> rhs.type;     is_neq(cmp)) return cmp;
+  if (auto cmp = int_only <=> rhs.int_only; is_neq(cmp)) return cmp;
   return weak_ordering::equivalent;
 }
 
@@ -916,7 +975,7 @@ vector<Byte> Memory::load(const Pointer &ptr, unsigned bytes, set<expr> &undef,
       unsigned idx = left2right ? i : (loaded_bytes - i - 1);
       expr off = offset + expr::mkUInt(idx, off_bits);
       loaded[i].add(is_poison ? Byte::mkPoisonByte(*this)()
-                              : blk.val.load(off), cond);
+                              : blk.load(off), cond);
       if (!is_poison)
         undef.insert(blk.undef.begin(), blk.undef.end());
     }
@@ -973,18 +1032,25 @@ void Memory::store(const Pointer &ptr,
 
   auto stored_ty = data_type(data, false);
   auto stored_ty_full = data_type(data, true);
+  bool int_bytes = has_int_only_blocks() && all_int_bytes(*this, data);
 
   auto fn = [&](MemBlock &blk, unsigned bid, bool local, expr &&cond) {
+    uint64_t blk_size;
+    bool full_write = Pointer(*this, bid, local).blockSize().isUInt(blk_size) &&
+                      blk_size == bytes;
+
+    // the old contents are gone, so the layout can be picked again
+    if (full_write && cond.isTrue() && local)
+      blk.int_only = int_bytes;
+    else if (!int_bytes)
+      blk.widen();
+
     auto mem = blk.val;
 
-    uint64_t blk_size;
-    bool full_write = false;
     // optimization: if fully rewriting the block, don't bother with the old
     // contents. Pick a value as the default one.
-    if (Pointer(*this, bid, local).blockSize().isUInt(blk_size) &&
-        blk_size == bytes) {
-      mem = expr::mkConstArray(offset, data[0].second);
-      full_write = true;
+    if (full_write) {
+      mem = expr::mkConstArray(offset, blk.repr(data[0].second));
       if (cond.isTrue()) {
         blk.undef.clear();
         blk.type = stored_ty_full;
@@ -1000,7 +1066,7 @@ void Memory::store(const Pointer &ptr,
         continue;
       expr off
        = offset + expr::mkUInt(idx >> Pointer::zeroBitsShortOffset(), off_bits);
-      mem = mem.store(off, val);
+      mem = mem.store(off, blk.repr(val));
     }
     blk.val = expr::mkIf(cond, mem, blk.val);
     blk.undef.insert(undef.begin(), undef.end());
@@ -1020,16 +1086,25 @@ void Memory::storeLambda(const Pointer &ptr, const expr &offset,
 
   bool val_no_offset = data.size() == 1 && !data[0].second.vars().count(offset);
   auto stored_ty = data_type(data, false);
+  bool int_bytes = has_int_only_blocks() && all_int_bytes(*this, data);
 
-  expr val = data.back().second;
+  expr val0 = data.back().second;
   expr mod = expr::mkUInt(data.size(), offset);
   for (auto I = next(data.rbegin()), E = data.rend(); I != E; ++I) {
-    val = expr::mkIf(offset.urem(mod) == I->first, I->second, val);
+    val0 = expr::mkIf(offset.urem(mod) == I->first, I->second, val0);
   }
 
   auto fn = [&](MemBlock &blk, unsigned bid, bool local, expr &&cond) {
+    bool full_write = bytes.eq(Pointer(*this, bid, local).blockSize());
+    if (full_write && cond.isTrue() && local)
+      blk.int_only = int_bytes;
+    else if (!int_bytes)
+      blk.widen();
+
+    auto val = blk.repr(val0);
+
     // optimization: full rewrite
-    if (bytes.eq(Pointer(*this, bid, local).blockSize())) {
+    if (full_write) {
       blk.val = val_no_offset && data.size() == 1
         ? expr::mkIf(cond, expr::mkConstArray(offset, val), blk.val)
         : expr::mkLambda(offset, expr::mkIf(cond, val, blk.val.load(offset)));
@@ -1052,6 +1127,65 @@ void Memory::storeLambda(const Pointer &ptr, const expr &offset,
   access(ptr, size, align, true, fn);
 }
 
+Memory::MemBlock* Memory::knownBlock(const Pointer &ptr, bool &local,
+                                     unsigned &bid) {
+  auto is_local = ptr.isLocal();
+  uint64_t n;
+  if (!is_local.isConst() || !ptr.getShortBid().isUInt(n))
+    return nullptr;
+
+  local = is_local.isTrue();
+  bid = n;
+  if (local)
+    return bid < local_block_val.size() ? &local_block_val[bid] : nullptr;
+  return bid < non_local_block_val.size() && !is_fncall_mem(bid)
+           ? &non_local_block_val[bid] : nullptr;
+}
+
+// Copies [src, src+bytes) to [dst, dst+bytes) with a single array update when
+// both pointers are rooted at distinct known blocks. Returns false otherwise.
+bool Memory::copyBlockRange(const Pointer &src, const Pointer &dst,
+                            const expr &bytes) {
+  bool src_local, dst_local;
+  unsigned src_bid, dst_bid;
+  auto *src_blk = knownBlock(src, src_local, src_bid);
+  auto *dst_blk = knownBlock(dst, dst_local, dst_bid);
+  if (!src_blk || !dst_blk || (src_local == dst_local && src_bid == dst_bid))
+    return false;
+
+  expr src_off = src.getShortOffset();
+  expr dst_off = dst.getShortOffset();
+  bool full_copy = src_off.isZero() && dst_off.isZero() &&
+                   bytes.eq(src.blockSize()) && bytes.eq(dst.blockSize());
+
+  if (full_copy) {
+    dst_blk->int_only = dst_local && src_blk->int_only;
+    dst_blk->val = src_blk->int_only && !dst_blk->int_only
+                     ? widen_int_array(src_blk->val) : src_blk->val;
+    dst_blk->undef = src_blk->undef;
+    dst_blk->type  = src_blk->type;
+    return true;
+  }
+
+  if (!src_blk->int_only)
+    dst_blk->widen();
+  expr src_val = src_blk->int_only && !dst_blk->int_only
+                   ? widen_int_array(src_blk->val) : src_blk->val;
+
+  expr offset
+    = expr::mkFreshVar("#off", expr::mkUInt(0, Pointer::bitsShortOffset()));
+  expr in_range = offset.uge(dst_off) &&
+                  offset.ult((dst + bytes).getShortOffset());
+  dst_blk->val
+    = expr::mkLambda(offset,
+                     expr::mkIf(in_range,
+                                src_val.load(offset - dst_off + src_off),
+                                dst_blk->val.load(offset)));
+  dst_blk->undef.insert(src_blk->undef.begin(), src_blk->undef.end());
+  dst_blk->type |= src_blk->type;
+  return true;
+}
+
 static bool memory_unused() {
   return num_locals_src == 0 && num_locals_tgt == 0 && num_nonlocals == 0;
 }
@@ -1149,10 +1283,11 @@ Memory::Memory(State &state) : state(&state), escaped_local_blks(*this) {
   // initialize all local blocks as non-pointer, poison value
   // This is okay because loading a pointer as non-pointer is also poison.
   if (numLocals() > 0) {
-    auto poison_array
+    MemBlock poison_blk(expr(), DATA_NONE, has_int_only_blocks());
+    poison_blk.val
       = expr::mkConstArray(expr::mkUInt(0, Pointer::bitsShortOffset()),
-                           Byte::mkPoisonByte(*this)());
-    local_block_val.resize(numLocals(), { std::move(poison_array), DATA_NONE });
+                           poison_blk.repr(Byte::mkPoisonByte(*this)()));
+    local_block_val.resize(numLocals(), poison_blk);
 
     // all local blocks are dead in the beginning
     local_block_liveness = expr::mkUInt(0, numLocals());
@@ -1925,7 +2060,7 @@ void Memory::memcpy(const expr &d, const expr &s, const expr &bytesize,
       to_store.emplace_back(i++ * bytesz, std::move(byte)());
     }
     store(dst, to_store, undef, align_dst);
-  } else {
+  } else if (!copyBlockRange(src, dst, bytesize)) {
     expr offset
       = expr::mkFreshVar("#off", expr::mkUInt(0, Pointer::bitsShortOffset()));
     Pointer ptr_src = src + (offset - dst.getShortOffset());
@@ -1953,19 +2088,28 @@ void Memory::copy(const Pointer &src, const Pointer &dst) {
   auto &dst_blk = (dst_local ? local_block_val : non_local_block_val)[dst_bid];
   dst_blk.undef.clear();
   dst_blk.type = DATA_NONE;
+  dst_blk.int_only = dst_local && has_int_only_blocks();
 
-  auto offset = expr::mkUInt(0, Pointer::bitsShortOffset());
-  DisjointExpr val(expr::mkConstArray(offset, Byte::mkPoisonByte(*this)()));
-
+  vector<pair<const MemBlock*, expr>> srcs;
   auto fn = [&](MemBlock &blk, unsigned bid, bool local, expr &&cond) {
     // we assume src != dst
     if (local == dst_local && bid == dst_bid)
       return;
-    val.add(blk.val, std::move(cond));
+    srcs.emplace_back(&blk, std::move(cond));
     dst_blk.undef.insert(blk.undef.begin(), blk.undef.end());
     dst_blk.type |= blk.type;
+    dst_blk.int_only &= blk.int_only;
   };
   access(src, bits_byte/8, bits_byte/8, false, fn);
+
+  auto offset = expr::mkUInt(0, Pointer::bitsShortOffset());
+  DisjointExpr val(
+    expr::mkConstArray(offset, dst_blk.repr(Byte::mkPoisonByte(*this)())));
+  for (auto &[blk, cond] : srcs) {
+    val.add(blk->int_only && !dst_blk.int_only ? widen_int_array(blk->val)
+                                               : blk->val,
+            std::move(cond));
+  }
   dst_blk.val = *std::move(val)();
 }
 
@@ -2070,7 +2214,8 @@ expr Memory::blockRefined(const Pointer &src, const Pointer &tgt, unsigned bid,
 tuple<expr, Pointer, set<expr>>
 Memory::refined(const Memory &other, bool fncall,
                 const vector<PtrInput> *set_ptrs,
-                const vector<PtrInput> *set_ptrs2) const {
+                const vector<PtrInput> *set_ptrs2,
+                vector<expr> *per_block) const {
   if (num_nonlocals == 0)
     return { true, Pointer(*this, expr()), {} };
 
@@ -2119,7 +2264,11 @@ Memory::refined(const Memory &other, bool fncall,
     Pointer q(other, p());
     if (p.isByval().isTrue() && q.isByval().isTrue())
       continue;
-    ret &= (ptr_bid == bid_expr).implies(blockRefined(p, q, bid, undef_vars));
+    auto blk = (ptr_bid == bid_expr).implies(blockRefined(p, q, bid,
+                                                          undef_vars));
+    if (per_block)
+      per_block->emplace_back(blk);
+    ret &= std::move(blk);
   }
 
   // restrict refinement check to set of request blocks
@@ -2132,6 +2281,10 @@ Memory::refined(const Memory &other, bool fncall,
       }
     }
     ret = c().implies(ret);
+    if (per_block) {
+      for (auto &blk : *per_block)
+        blk = c().implies(blk);
+    }
   }
 
   // TODO: missing refinement of escaped local blocks!
@@ -2197,13 +2350,19 @@ Memory Memory::mkIf(const expr &cond, Memory &&then, Memory &&els) {
       = expr::mkIf(cond, then.non_local_block_val[bid].val, other.val);
     ret.non_local_block_val[bid].undef.insert(other.undef.begin(),
                                               other.undef.end());
+    ret.non_local_block_val[bid].type |= other.type;
   }
   for (unsigned bid = 0, end = ret.numLocals(); bid < end; ++bid) {
     auto &other = els.local_block_val[bid];
+    if (then.local_block_val[bid].int_only != other.int_only) {
+      then.local_block_val[bid].widen();
+      other.widen();
+    }
     ret.local_block_val[bid].val
       = expr::mkIf(cond, then.local_block_val[bid].val, other.val);
     ret.local_block_val[bid].undef.insert(other.undef.begin(),
                                           other.undef.end());
+    ret.local_block_val[bid].type |= other.type;
   }
   ret.non_local_block_liveness = expr::mkIf(cond, then.non_local_block_liveness,
                                             els.non_local_block_liveness);
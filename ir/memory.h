@@ -121,11 +121,21 @@ class Memory {
     smt::expr val; // array: short offset -> Byte
     std::set<smt::expr> undef;
     unsigned char type = DATA_ANY;
+    // Local blocks that never held a pointer store only the non-pointer
+    // part of their bytes (no pointer bit nor padding).
+    bool int_only = false;
 
     MemBlock() {}
     MemBlock(smt::expr &&val) : val(std::move(val)) {}
-    MemBlock(smt::expr &&val, DataType type)
-      : val(std::move(val)), type(type) {}
+    MemBlock(smt::expr &&val, DataType type, bool int_only = false)
+      : val(std::move(val)), type(type), int_only(int_only) {}
+
+    // Returns the full Byte representation of the byte at offset
+    smt::expr load(const smt::expr &offset) const;
+    // Converts a full Byte representation into this block's layout
+    smt::expr repr(const smt::expr &byte) const;
+    // Switches to the layout that can hold any byte
+    void widen();
 
     std::weak_ordering operator<=>(const MemBlock &rhs) const;
   };
@@ -197,6 +207,10 @@ class Memory {
                    const std::vector<std::pair<unsigned, smt::expr>> &data,
                    const std::set<smt::expr> &undef, uint64_t align);
 
+  MemBlock* knownBlock(const Pointer &ptr, bool &local, unsigned &bid);
+  bool copyBlockRange(const Pointer &src, const Pointer &dst,
+                      const smt::expr &bytes);
+
   smt::expr blockValRefined(const Memory &other, unsigned bid, bool local,
                             const smt::expr &offset,
                             std::set<smt::expr> &undef) const;
@@ -327,10 +341,13 @@ public:
   smt::expr ptr2int(const smt::expr &ptr) const;
   smt::expr int2ptr(const smt::expr &val) const;
 
+  // If per_block is given, it also receives the refinement constraint of each
+  // checked block separately; their conjunction is equivalent to the result.
   std::tuple<smt::expr, Pointer, std::set<smt::expr>>
     refined(const Memory &other, bool fncall,
             const std::vector<PtrInput> *set_ptrs = nullptr,
-            const std::vector<PtrInput> *set_ptrs_other = nullptr) const;
+            const std::vector<PtrInput> *set_ptrs_other = nullptr,
+            std::vector<smt::expr> *per_block = nullptr) const;
 
   // Returns true if a nocapture pointer byte is not in the memory.
   smt::expr checkNocapture() const;
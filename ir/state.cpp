@@ -148,7 +148,10 @@ State::State(const Function &f, bool source)
   : f(f), source(source), memory(*this),
     fp_rounding_mode(expr::mkVar("fp_rounding_mode", 3)),
     return_val(DisjointExpr(f.getType().getDummyValue(false))),
-    return_memory(DisjointExpr(memory.dup())) {}
+    return_memory(DisjointExpr(memory.dup())) {
+  if (source)
+    fm_egraph = make_shared<FastMathEGraph>();
+}
 
 void State::resetGlobals() {
   Memory::resetGlobals();
@@ -439,7 +442,7 @@ const StateValue& State::operator[](const Value &val) {
     repls.emplace_back(u, expr::mkFreshVar("undef", u));
   }
 
-  if (hit_half_memory_limit())
+  if (memory_pressure() == MemoryPressure::Abort)
     throw_oom_exception();
 
   auto sval_new = sval.subst(repls);
@@ -561,8 +564,16 @@ bool State::startBB(const BasicBlock &bb) {
   if (I == predecessor_data.end())
     return false;
 
-  if (hit_memory_limit())
+  switch (memory_pressure()) {
+  case MemoryPressure::None:
+    break;
+  case MemoryPressure::Release:
+  case MemoryPressure::Degrade:
+    releaseSinkData();
+    break;
+  case MemoryPressure::Abort:
     throw_oom_exception();
+  }
 
   DisjointExpr<Memory> in_memory;
   DisjointExpr<expr> UB;
@@ -993,7 +1004,7 @@ void State::resetUndefVars() {
 StateValue State::rewriteUndef(StateValue &&val, const set<expr> &undef_vars) {
   if (undef_vars.empty())
     return std::move(val);
-  if (hit_half_memory_limit())
+  if (memory_pressure() == MemoryPressure::Abort)
     throw_oom_exception();
 
   vector<pair<expr, expr>> repls;
@@ -1021,6 +1032,20 @@ void State::saveReturnedInput() {
   }
 }
 
+void State::releaseSinkData() {
+  // only the path conditions of the jumps to the sink are ever used
+  auto I = predecessor_data.find(&f.getSinkBB());
+  if (I == predecessor_data.end())
+    return;
+
+  for (auto &[src, data] : I->second) {
+    data.mem = {};
+    data.undef_vars.clear();
+    data.analysis = {};
+    data.var_args = {};
+  }
+}
+
 expr State::sinkDomain() const {
   auto I = predecessor_data.find(&f.getSinkBB());
   if (I == predecessor_data.end())
@@ -1087,6 +1112,7 @@ void State::syncSEdataWithSrc(State &src) {
 
   fn_call_data = std::move(src.fn_call_data);
   inaccessiblemem_bids = std::move(src.inaccessiblemem_bids);
+  fm_egraph = src.fm_egraph;
   memory.syncWithSrc(src.returnMemory());
 }
 
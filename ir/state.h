@@ -3,12 +3,14 @@
 // Copyright (c) 2018-present The Alive2 Authors.
 // Distributed under the MIT license that can be found in the LICENSE file.
 
+#include "ir/fast_math.h"
 #include "ir/memory.h"
 #include "ir/state_value.h"
 #include "smt/expr.h"
 #include "smt/exprs.h"
 #include <array>
 #include <map>
+#include <memory>
 #include <ostream>
 #include <set>
 #include <string>
@@ -185,7 +187,11 @@ private:
 
   VarArgsData var_args_data;
 
+  // e-graph of FP values shared by src & tgt
+  std::shared_ptr<FastMathEGraph> fm_egraph;
+
   const StateValue& returnValCached();
+  void releaseSinkData();
 
 public:
   State(const Function &f, bool source);
@@ -230,6 +236,8 @@ public:
 
   auto& getVarArgsData() { return var_args_data.data; }
 
+  auto& getFastMathEGraph() { return *fm_egraph; }
+
   void doesApproximation(std::string &&name, std::optional<smt::expr> e = {});
   auto& getApproximations() const { return used_approximations; }
 
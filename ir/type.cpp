@@ -6,6 +6,7 @@
 #include "ir/state.h"
 #include "smt/solver.h"
 #include "util/compiler.h"
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <numeric>
@@ -84,6 +85,10 @@ expr Type::operator==(const Type &b) const {
   return false;
 }
 
+bool Type::isConcrete() const {
+  return false;
+}
+
 bool Type::isIntType() const {
   return false;
 }
@@ -293,6 +298,10 @@ expr VoidType::getTypeConstraints() const {
   return true;
 }
 
+bool VoidType::isConcrete() const {
+  return true;
+}
+
 void VoidType::fixup(const Model &m) {
   // do nothing
 }
@@ -334,6 +343,10 @@ expr IntType::getTypeConstraints() const {
   return r;
 }
 
+bool IntType::isConcrete() const {
+  return defined;
+}
+
 expr IntType::sizeVar() const {
   return defined ? expr::mkUInt(bits(), var_bw_bits) : Type::sizeVar();
 }
@@ -517,6 +530,10 @@ expr FloatType::getTypeConstraints() const {
   return r;
 }
 
+bool FloatType::isConcrete() const {
+  return defined;
+}
+
 expr FloatType::operator==(const FloatType &rhs) const {
   return sizeVar() == rhs.sizeVar();
 }
@@ -547,8 +564,9 @@ pair<expr, expr>
 FloatType::refines(State &src_s, State &tgt_s, const StateValue &src,
                    const StateValue &tgt) const {
   expr non_poison = src.non_poison && tgt.non_poison;
-  return { src.non_poison.implies(tgt.non_poison),
-           (src.non_poison && tgt.non_poison).implies(src.value == tgt.value) };
+  // values equal modulo fast-math rewrites need no FP reasoning
+  auto eq = src_s.getFastMathEGraph().refined(src.value, tgt.value);
+  return { src.non_poison.implies(tgt.non_poison), non_poison.implies(eq) };
 }
 
 expr FloatType::mkInput(State &s, const char *name,
@@ -620,6 +638,10 @@ expr PtrType::getTypeConstraints() const {
   return sizeVar() == bits();
 }
 
+bool PtrType::isConcrete() const {
+  return defined;
+}
+
 expr PtrType::sizeVar() const {
   return defined ? expr::mkUInt(bits(), var_bw_bits) : Type::sizeVar();
 }
@@ -837,6 +859,16 @@ StateValue AggregateType::getDummyValue(bool non_poison) const {
 }
 
 expr AggregateType::getTypeConstraints() const {
+  if (concrete_constraints)
+    return *concrete_constraints;
+
+  expr r = typeConstraints();
+  if (r.isConst())
+    concrete_constraints = r.isTrue();
+  return r;
+}
+
+expr AggregateType::typeConstraints() const {
   expr r(true), elems = numElements();
   for (unsigned i = 0, e = children.size(); i != e; ++i) {
     r &= elems.ugt(i).implies(children[i]->getTypeConstraints());
@@ -846,6 +878,14 @@ expr AggregateType::getTypeConstraints() const {
   return r;
 }
 
+bool AggregateType::isConcrete() const {
+  if (!concrete)
+    concrete = defined &&
+               all_of(children.begin(), children.end(),
+                      [](auto *ty) { return ty->isConcrete(); });
+  return *concrete;
+}
+
 expr AggregateType::sizeVar() const {
   expr elems = numElements();
   expr sz = expr::mkUInt(0, var_bw_bits);
@@ -1081,9 +1121,9 @@ unsigned VectorType::np_bits() const {
   return Type::np_bits();
 }
 
-expr VectorType::getTypeConstraints() const {
+expr VectorType::typeConstraints() const {
   auto &elementTy = *children[0];
-  expr r = AggregateType::getTypeConstraints() &&
+  expr r = AggregateType::typeConstraints() &&
            (elementTy.enforceIntType() ||
             elementTy.enforceFloatType() ||
             elementTy.enforcePtrType()) &&
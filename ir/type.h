@@ -49,6 +49,8 @@ public:
   virtual IR::StateValue getDummyValue(bool non_poison) const = 0;
 
   virtual smt::expr getTypeConstraints() const = 0;
+  // true if the type has no symbolic parts
+  virtual bool isConcrete() const;
   virtual smt::expr sizeVar() const;
   virtual smt::expr scalarSize() const;
   smt::expr operator==(const Type &rhs) const;
@@ -135,6 +137,7 @@ public:
   unsigned bits() const override;
   IR::StateValue getDummyValue(bool non_poison) const override;
   smt::expr getTypeConstraints() const override;
+  bool isConcrete() const override;
   void fixup(const smt::Model &m) override;
   std::pair<smt::expr, smt::expr>
     refines(State &src_s, State &tgt_s, const StateValue &src,
@@ -159,6 +162,7 @@ public:
   unsigned bits() const override;
   IR::StateValue getDummyValue(bool non_poison) const override;
   smt::expr getTypeConstraints() const override;
+  bool isConcrete() const override;
   smt::expr sizeVar() const override;
   smt::expr operator==(const IntType &rhs) const;
   void fixup(const smt::Model &m) override;
@@ -196,6 +200,7 @@ public:
 
   IR::StateValue getDummyValue(bool non_poison) const override;
   smt::expr getTypeConstraints() const override;
+  bool isConcrete() const override;
   smt::expr sizeVar() const override;
   smt::expr operator==(const FloatType &rhs) const;
   void fixup(const smt::Model &m) override;
@@ -234,6 +239,7 @@ public:
   unsigned np_bits() const override;
   IR::StateValue getDummyValue(bool non_poison) const override;
   smt::expr getTypeConstraints() const override;
+  bool isConcrete() const override;
   smt::expr sizeVar() const override;
   smt::expr operator==(const PtrType &rhs) const;
   void fixup(const smt::Model &m) override;
@@ -265,6 +271,10 @@ protected:
   std::vector<std::unique_ptr<SymbolicType>> sym;
   unsigned elements;
   bool defined = false;
+  // the constraints of a concrete type hold for any typing (or none), so
+  // they are only built once
+  mutable std::optional<bool> concrete_constraints;
+  mutable std::optional<bool> concrete;
 
   AggregateType(std::string &&name, bool symbolic = true);
   AggregateType(std::string &&name, std::vector<Type*> &&children,
@@ -276,6 +286,10 @@ public:
   unsigned numElementsConst() const { return elements; }
   unsigned numPaddingsConst() const;
 
+protected:
+  virtual smt::expr typeConstraints() const;
+
+public:
   StateValue aggregateVals(const std::vector<StateValue> &vals) const;
   StateValue extract(const StateValue &val, unsigned index,
                      bool fromInt = false) const;
@@ -287,7 +301,8 @@ public:
   unsigned np_bits() const override;
   // Padding is filled with poison regardless of non_poison.
   IR::StateValue getDummyValue(bool non_poison) const override;
-  smt::expr getTypeConstraints() const override;
+  smt::expr getTypeConstraints() const final;
+  bool isConcrete() const override;
   smt::expr sizeVar() const override;
   smt::expr operator==(const AggregateType &rhs) const;
   void fixup(const smt::Model &m) override;
@@ -336,7 +351,7 @@ public:
                         const IR::StateValue &val,
                         const smt::expr &idx) const;
   unsigned np_bits() const override;
-  smt::expr getTypeConstraints() const override;
+  smt::expr typeConstraints() const override;
   smt::expr scalarSize() const override;
   bool isVectorType() const override;
   smt::expr enforceVectorType(
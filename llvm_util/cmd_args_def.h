@@ -11,6 +11,10 @@ config::src_unroll_cnt = opt_unrolling_factor;
 config::disable_undef_input = opt_disable_undef;
 config::disable_poison_input = opt_disable_poison;
 config::symexec_print_each_value = opt_se_verbose;
+#ifdef ARGS_REFINEMENT
+config::split_memory_check = opt_split_memory_check;
+config::split_lane_check = opt_split_lane_check;
+#endif
 smt::set_query_timeout(to_string(opt_smt_to));
 smt::set_memory_limit((uint64_t)opt_smt_max_mem * 1024 * 1024);
 smt::set_random_seed(to_string(opt_smt_random_seed));
@@ -79,6 +83,19 @@ if (!opt_outputfile.empty()) {
 
 util::config::set_debug(*out);
 
+if (!opt_result_stream.empty() && !result_stream.isOpen() &&
+    !result_stream.open(opt_result_stream.c_str())) {
+  cerr << "Alive2: Couldn't open result stream file!" << endl;
+  exit(1);
+}
+
+if (!opt_time_stages.empty())
+  util::stage_times_enable(opt_time_stages.c_str());
+
+if (!opt_trace.empty() && !util::trace_enable(opt_trace.c_str())) {
+  cerr << "Alive2: Couldn't open trace file!" << endl;
+  exit(1);
+}
 
 if (opt_cache) {
 #ifdef NO_REDIS_SUPPORT
@@ -1,8 +1,10 @@
 // Copyright (c) 2018-present The Alive2 Authors.
 // Distributed under the MIT license that can be found in the LICENSE file.
 
+#include "tools/result_stream.h"
 #include "util/config.h"
 #include "util/random.h"
+#include "util/stopwatch.h"
 #include "llvm/Support/CommandLine.h"
 #include <filesystem>
 
@@ -89,6 +91,12 @@ llvm::cl::opt<bool> opt_tactic_verbose(LLVM_ARGS_PREFIX "tactic-verbose",
 llvm::cl::opt<bool> opt_always_verify(LLVM_ARGS_PREFIX "always-verify",
   llvm::cl::desc("Verify transformations even if they are syntactically equal"),
   llvm::cl::init(false), llvm::cl::cat(alive_cmdargs));
+
+llvm::cl::opt<unsigned> opt_translation_threads(
+  LLVM_ARGS_PREFIX "translation-threads",
+  llvm::cl::desc("Number of threads used to translate the functions of a "
+                 "module before verifying them (default=1)"),
+  llvm::cl::init(1), llvm::cl::cat(alive_cmdargs));
 #endif
 
 llvm::cl::opt<bool> opt_quiet(LLVM_ARGS_PREFIX "quiet",
@@ -107,16 +115,41 @@ llvm::cl::opt<bool> opt_alias_stats(LLVM_ARGS_PREFIX "alias-stats",
   llvm::cl::desc("Show alias sets statistics"),
   llvm::cl::init(false), llvm::cl::cat(alive_cmdargs));
 
+llvm::cl::opt<bool> opt_known_fns_stats(LLVM_ARGS_PREFIX "known-fns-stats",
+  llvm::cl::desc("Show statistics of the known library calls cache"),
+  llvm::cl::init(false), llvm::cl::cat(alive_cmdargs));
+
 #ifdef ARGS_REFINEMENT
 llvm::cl::opt<bool> opt_bidirectional(LLVM_ARGS_PREFIX "bidirectional",
   llvm::cl::desc("Run refinement check in both directions"),
   llvm::cl::init(false), llvm::cl::cat(alive_cmdargs));
+
+llvm::cl::opt<bool> opt_split_memory_check(
+  LLVM_ARGS_PREFIX "split-memory-check",
+  llvm::cl::desc("Check memory refinement with one SMT query per block "
+                 "(default=false)"),
+  llvm::cl::init(false), llvm::cl::cat(alive_cmdargs));
+
+llvm::cl::opt<bool> opt_split_lane_check(LLVM_ARGS_PREFIX "split-lane-check",
+  llvm::cl::desc("Check refinement of vectors and aggregates with one SMT "
+                 "query per element (default=false)"),
+  llvm::cl::init(false), llvm::cl::cat(alive_cmdargs));
 #endif
 
 llvm::cl::opt<bool> opt_elapsed_time(LLVM_ARGS_PREFIX "time-verify",
   llvm::cl::desc("Print time taken to verify each transformation"),
   llvm::cl::init(false), llvm::cl::cat(alive_cmdargs));
 
+llvm::cl::opt<string> opt_time_stages(LLVM_ARGS_PREFIX "time-stages",
+  llvm::cl::desc("Append the time taken by each verification stage to the "
+                 "given file, in the folded format used by flamegraph.pl"),
+  llvm::cl::value_desc("filename"), llvm::cl::cat(alive_cmdargs));
+
+llvm::cl::opt<string> opt_trace(LLVM_ARGS_PREFIX "trace",
+  llvm::cl::desc("Append a timeline of the verification stages of all "
+                 "processes to the given file (Chrome trace format)"),
+  llvm::cl::value_desc("filename"), llvm::cl::cat(alive_cmdargs));
+
 llvm::cl::opt<string> opt_outputfile(LLVM_ARGS_PREFIX "o",
   llvm::cl::desc("Specify output filename"), llvm::cl::cat(alive_cmdargs));
 
@@ -130,6 +163,13 @@ llvm::cl::opt<string> opt_report_dir(LLVM_ARGS_PREFIX "report-dir",
 bool report_dir_created = false;
 fs::path report_filename;
 
+llvm::cl::opt<string> opt_result_stream(LLVM_ARGS_PREFIX "result-stream",
+  llvm::cl::desc("Append a JSON record with the result of each verified "
+                 "function to the given file"),
+  llvm::cl::value_desc("filename"), llvm::cl::cat(alive_cmdargs));
+
+tools::ResultStream result_stream;
+
 llvm::cl::opt<bool> opt_save_ir(LLVM_ARGS_PREFIX "save-ir",
   llvm::cl::desc("Save LLVM IR into the report directory upon encountering a "
                  "verification error"),
@@ -8,11 +8,56 @@
 #include "llvm/IR/Constants.h"
 #include "llvm/Analysis/MemoryBuiltins.h"
 #include "llvm/Analysis/TargetLibraryInfo.h"
+#include <atomic>
+#include <iomanip>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 using namespace IR;
 using namespace std;
 
+namespace {
+// Resolved TLI lookups, keyed by callee. The name, prototype and module are
+// kept to detect a function that was renamed or freed and reallocated.
+struct LibFnEntry {
+  string name;
+  const llvm::FunctionType *proto;
+  const llvm::Module *module;
+  llvm::LibFunc libfn;
+  bool is_libfn;
+};
+
+unordered_map<const llvm::Function*, LibFnEntry> libfn_cache;
+mutex libfn_cache_mutex;
+uint64_t num_lookups = 0;
+uint64_t num_hits = 0;
+atomic<uint64_t> num_known = 0;
+}
+
+// Availability (TLI.has) depends on the caller's attributes, so only the
+// name/prototype matching is cached.
+static bool get_libfn(const llvm::Function &f,
+                      const llvm::TargetLibraryInfo &TLI,
+                      llvm::LibFunc &libfn) {
+  lock_guard lock(libfn_cache_mutex);
+  ++num_lookups;
+  auto [I, inserted] = libfn_cache.try_emplace(&f);
+  auto &e = I->second;
+  if (!inserted && e.proto == f.getFunctionType() &&
+      e.module == f.getParent() && e.name == f.getName()) {
+    ++num_hits;
+  } else {
+    e.name     = f.getName().str();
+    e.proto    = f.getFunctionType();
+    e.module   = f.getParent();
+    e.is_libfn = TLI.getLibFunc(f, e.libfn);
+  }
+  libfn = e.libfn;
+  return e.is_libfn && TLI.has(libfn);
+}
+
 #define RETURN_EXACT()  return false
 #define RETURN_APPROX() return true
 
@@ -492,11 +537,25 @@ static bool implict_attrs_(llvm::LibFunc libfn, FnAttrs &attrs,
 
 namespace llvm_util {
 
+void known_fns_reset_cache() {
+  lock_guard lock(libfn_cache_mutex);
+  libfn_cache.clear();
+}
+
+void known_fns_print_stats(ostream &os) {
+  float hit_pc = num_lookups == 0 ? 0 : (num_hits * 100.0) / num_lookups;
+  os << fixed << setprecision(1);
+  os << "\n------------------- KNOWN FNS -------------------\n"
+        "Num lookups: " << num_lookups << "\n"
+        "Num hits:    " << num_hits << " (" << hit_pc << "%)\n"
+        "Num lowered: " << num_known << '\n';
+}
+
 bool llvm_implict_attrs(llvm::Function &f, const llvm::TargetLibraryInfo &TLI,
                         FnAttrs &attrs, vector<ParamAttrs> &param_attrs,
                         const vector<Value*> &args) {
   llvm::LibFunc libfn;
-  if (!TLI.getLibFunc(f, libfn) || !TLI.has(libfn))
+  if (!get_libfn(f, TLI, libfn))
     return false;
   return implict_attrs_(libfn, attrs, param_attrs,
                         f.getReturnType()->isVoidTy(), args);
@@ -505,7 +564,7 @@ bool llvm_implict_attrs(llvm::Function &f, const llvm::TargetLibraryInfo &TLI,
 #undef RETURN_EXACT
 #undef RETURN_APPROX
 
-#define RETURN_VAL(op)  return { op, false }
+#define RETURN_VAL(op)  do { ++num_known; return { op, false }; } while (0)
 #define RETURN_EXACT()  return { nullptr, false }
 #define RETURN_APPROX() return { nullptr, true }
 
@@ -526,7 +585,7 @@ known_call(llvm::CallInst &i, const llvm::TargetLibraryInfo &TLI,
   }
 
   llvm::LibFunc libfn;
-  if (!decl || !TLI.getLibFunc(*decl, libfn) || !TLI.has(libfn))
+  if (!decl || !get_libfn(*decl, TLI, libfn))
     RETURN_EXACT();
 
   switch (libfn) {
@@ -4,6 +4,7 @@
 // Distributed under the MIT license that can be found in the LICENSE file.
 
 #include <memory>
+#include <ostream>
 #include <vector>
 
 namespace llvm {
@@ -22,6 +23,10 @@ class Value;
 
 namespace llvm_util {
 
+// Drops the per-module cache of resolved library functions
+void known_fns_reset_cache();
+void known_fns_print_stats(std::ostream &os);
+
 // returns true if it's a known function call
 bool llvm_implict_attrs(llvm::Function &f, const llvm::TargetLibraryInfo &TLI,
                         IR::FnAttrs &attrs,
@@ -16,6 +16,9 @@
 #include "llvm/IR/InstVisitor.h"
 #include "llvm/IR/IntrinsicsX86.h"
 #include "llvm/IR/Operator.h"
+#include <atomic>
+#include <sstream>
+#include <thread>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
@@ -57,10 +60,6 @@ FpExceptionMode parse_exceptions(llvm::Instruction &i) {
   }
 }
 
-unsigned constexpr_idx;
-unsigned copy_idx;
-unsigned alignopbundle_idx;
-
 #if 0
 string_view s(llvm::StringRef str) {
   return { str.data(), str.size() };
@@ -111,6 +110,9 @@ class llvm2alive_ : public llvm::InstVisitor<llvm2alive_, unique_ptr<Instr>> {
   ostream *out;
   // (LLVM alloca, (Alive2 alloc, has lifetime.start?))
   map<const llvm::AllocaInst *, std::pair<Alloc *, bool>> allocs;
+  unsigned constexpr_idx = 0;
+  unsigned copy_idx = 0;
+  unsigned alignopbundle_idx = 0;
 
 
   using RetTy = unique_ptr<Instr>;
@@ -130,8 +132,13 @@ class llvm2alive_ : public llvm::InstVisitor<llvm2alive_, unique_ptr<Instr>> {
   }
 
   Value* convert_constexpr(llvm::ConstantExpr *cexpr) {
-    llvm::Instruction *newI = cexpr->getAsInstruction();
-    newI->setName("__constexpr_" + to_string(constexpr_idx++));
+    llvm::Instruction *newI;
+    {
+      lock_guard lock(get_llvm_mutex());
+      newI = cexpr->getAsInstruction();
+    }
+    // named on our side only; the LLVM context is shared across threads
+    set_value_name(*newI, "%__constexpr_" + to_string(constexpr_idx++));
     i_constexprs.push_back(newI);
 
     auto ptr = this->visit(*newI);
@@ -164,10 +171,16 @@ class llvm2alive_ : public llvm::InstVisitor<llvm2alive_, unique_ptr<Instr>> {
         [&](auto ag) { return copy_inserter(ag); });
   }
 
+  static llvm::Constant* get_bool(llvm::LLVMContext &ctx, bool val) {
+    lock_guard lock(get_llvm_mutex());
+    return val ? llvm::ConstantInt::getTrue(ctx)
+               : llvm::ConstantInt::getFalse(ctx);
+  }
+
   RetTy NOP(llvm::Instruction &i) {
     // some NOP instruction
     assert(i.getType()->isVoidTy());
-    auto true_val = get_operand(llvm::ConstantInt::getTrue(i.getContext()));
+    auto true_val = get_operand(get_bool(i.getContext(), true));
     return make_unique<Assume>(*true_val, Assume::AndNonPoison);
   }
 
@@ -178,6 +191,7 @@ public:
         out(&get_outs()) {}
 
   ~llvm2alive_() {
+    lock_guard lock(get_llvm_mutex());
     for (auto &inst : i_constexprs) {
       remove_value_name(*inst); // otherwise value_names maintain freed pointers
       inst->deleteValue();
@@ -534,7 +548,7 @@ public:
 
     auto gep = make_unique<GEP>(*ty, value_name(i), *ptr, i.isInBounds());
     auto gep_struct_ofs = [&i, this](llvm::StructType *sty, llvm::Value *ofs) {
-      llvm::Value *vals[] = { llvm::ConstantInt::getFalse(i.getContext()), ofs };
+      llvm::Value *vals[] = { get_bool(i.getContext(), false), ofs };
       return this->DL().getIndexedOffsetInType(sty,
           llvm::makeArrayRef(vals, 2));
     };
@@ -548,11 +562,11 @@ public:
 
       if (auto structTy = I.getStructTypeOrNull()) {
         auto opty = I.getOperand()->getType();
-        auto ofs_ty = llvm::IntegerType::get(i.getContext(), 64);
-
         if (auto opvty = dyn_cast<llvm::VectorType>(opty)) {
           assert(!isa<llvm::ScalableVectorType>(opvty));
           vector<llvm::Constant *> offsets;
+          unique_lock lock(get_llvm_mutex());
+          auto ofs_ty = llvm::IntegerType::get(i.getContext(), 64);
 
           for (unsigned i = 0; i < opvty->getElementCount().getKnownMinValue();
                ++i) {
@@ -571,6 +585,7 @@ public:
 
           auto ofs_vector = llvm::ConstantVector::get(
               llvm::makeArrayRef(offsets.data(), offsets.size()));
+          lock.unlock();
           gep->addIdx(1, *get_operand(ofs_vector));
         } else {
           gep->addIdx(1, *make_intconst(
@@ -656,7 +671,7 @@ public:
   }
 
   RetTy visitUnreachableInst(llvm::UnreachableInst &i) {
-    auto fals = get_operand(llvm::ConstantInt::getFalse(i.getContext()));
+    auto fals = get_operand(get_bool(i.getContext(), false));
     return make_unique<Assume>(*fals, Assume::AndNonPoison);
   }
 
@@ -1517,10 +1532,6 @@ public:
 
 
   optional<Function> run() {
-    constexpr_idx = 0;
-    copy_idx = 0;
-    alignopbundle_idx = 0;
-
     // don't even bother if number of BBs or instructions is huge..
     if (distance(f.begin(), f.end()) > 5000 ||
         f.getInstructionCount() > 10000) {
@@ -1704,6 +1715,8 @@ public:
     else
       BB->addInstr(make_unique<Branch>(Fn.getBB(entry_name)));
 
+    // LLVM IR passed the verifier, so there's nothing left to type check
+    Fn.setWellTyped();
     return Fn;
   }
 };
@@ -1713,6 +1726,7 @@ namespace llvm_util {
 
 initializer::initializer(ostream &os, const llvm::DataLayout &DL) {
   init_llvm_utils(os, DL);
+  known_fns_reset_cache();
 }
 
 optional<IR::Function> llvm2alive(llvm::Function &F,
@@ -1721,4 +1735,32 @@ optional<IR::Function> llvm2alive(llvm::Function &F,
                                   const vector<string_view> &gvnamesInSrc) {
   return llvm2alive_(F, TLI, IsSrc, gvnamesInSrc).run();
 }
+
+vector<string> llvm2alive_parallel(unsigned num_jobs, unsigned num_threads,
+                                   const function<void(unsigned)> &job) {
+  vector<string> outputs(num_jobs);
+  atomic<unsigned> next_job = 0;
+
+  auto worker = [&]() {
+    unsigned i;
+    while ((i = next_job++) < num_jobs) {
+      ostringstream os;
+      set_thread_outs(&os);
+      job(i);
+      set_thread_outs(nullptr);
+      outputs[i] = std::move(os).str();
+    }
+  };
+
+  num_threads = max(1u, min(num_threads, num_jobs));
+  vector<thread> threads;
+  for (unsigned i = 1; i < num_threads; ++i) {
+    threads.emplace_back(worker);
+  }
+  worker();
+  for (auto &t : threads) {
+    t.join();
+  }
+  return outputs;
+}
 }
@@ -4,6 +4,7 @@
 // Distributed under the MIT license that can be found in the LICENSE file.
 
 #include "ir/function.h"
+#include <functional>
 #include <optional>
 #include <ostream>
 #include <string>
@@ -24,4 +25,12 @@ struct initializer {
 std::optional<IR::Function>
 llvm2alive(llvm::Function &F, const llvm::TargetLibraryInfo &TLI, bool IsSrc,
            const std::vector<std::string_view> &gvnamesInSrc = {});
+
+// Runs job(0), ..., job(num_jobs-1) on up to num_threads threads. Jobs may
+// call llvm2alive on functions of the same module concurrently. Whatever the
+// translations of job i print is returned in the i-th string, so that callers
+// can replay it in order.
+std::vector<std::string>
+llvm2alive_parallel(unsigned num_jobs, unsigned num_threads,
+                    const std::function<void(unsigned)> &job);
 }
@@ -12,6 +12,9 @@
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Operator.h"
 #include "llvm/Support/raw_ostream.h"
+#include <map>
+#include <mutex>
+#include <tuple>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -22,9 +25,20 @@ using llvm::cast, llvm::dyn_cast, llvm::isa;
 
 namespace {
 
+// Per-translation state. Each thread translates one function at a time, so
+// this is the context of the llvm2alive call running in the current thread.
+thread_local Function *current_fn;
+thread_local unordered_map<const llvm::Value*, Value*> value_cache;
+
 // cache Value*'s names
-unordered_map<const llvm::Value*, string> value_names;
-unsigned value_id_counter; // for %0, %1, etc..
+thread_local unordered_map<const llvm::Value*, string> value_names;
+thread_local unsigned value_id_counter; // for %0, %1, etc..
+
+thread_local ostream *thread_out;
+
+// State shared by all translations. Guarded by llvm_mutex, together with
+// the LLVM context, as translations may run concurrently.
+recursive_mutex llvm_mutex;
 
 vector<unique_ptr<IntType>> int_types;
 vector<unique_ptr<PtrType>> ptr_types;
@@ -35,11 +49,25 @@ FloatType quad_type("fp128", FloatType::Quad);
 FloatType bfloat_type("bfloat", FloatType::BFloat);
 
 // cache complex types
-unordered_map<const llvm::Type*, unique_ptr<Type>> type_cache;
+unordered_map<const llvm::Type*, Type*> type_cache;
 unsigned type_id_counter; // for unamed types
 
-Function *current_fn;
-unordered_map<const llvm::Value*, Value*> value_cache;
+// Complex types are hash-consed on their structure and shared by all
+// functions, so e.g. %struct.S and %struct.S.0 map to the same type.
+// Key: (type id, #elements, element types, padding)
+map<tuple<unsigned, uint64_t, vector<Type*>, vector<bool>>, unique_ptr<Type>>
+  interned_types;
+
+template <typename T, typename... Args>
+Type* intern(llvm::Type::TypeID id, uint64_t elems, vector<Type*> &&children,
+             vector<bool> &&is_padding, Args&&... args) {
+  auto &ty = interned_types[{ id, elems, std::move(children),
+                              std::move(is_padding) }];
+  if (!ty)
+    ty = make_unique<T>("ty_" + to_string(type_id_counter++),
+                        std::forward<Args>(args)...);
+  return ty.get();
+}
 
 ostream *out;
 
@@ -101,11 +129,16 @@ string value_name(const llvm::Value &v) {
                                         : '%' + to_string(value_id_counter++);
 }
 
+void set_value_name(const llvm::Value &v, string &&name) {
+  value_names[&v] = std::move(name);
+}
+
 void remove_value_name(const llvm::Value &v) {
   value_names.erase(&v);
 }
 
 Type& get_int_type(unsigned bits) {
+  lock_guard lock(llvm_mutex);
   if (bits >= int_types.size())
     int_types.resize(bits + 1);
   if (!int_types[bits])
@@ -129,7 +162,12 @@ Type* llvm_type2alive(const llvm::Type *ty) {
     return &quad_type;
   case llvm::Type::BFloatTyID:
     return &bfloat_type;
+  default:
+    break;
+  }
 
+  lock_guard lock(llvm_mutex);
+  switch (ty->getTypeID()) {
   case llvm::Type::PointerTyID: {
     // TODO: support for non-64 bits pointers
     unsigned as = cast<llvm::PointerType>(ty)->getAddressSpace();
@@ -176,10 +214,13 @@ Type* llvm_type2alive(const llvm::Type *ty) {
             return nullptr;
         }
       }
-      cache = make_unique<StructType>("ty_" + to_string(type_id_counter++),
-                                      std::move(elems), std::move(is_padding));
+      auto key_elems = elems;
+      auto key_padding = is_padding;
+      cache = intern<StructType>(ty->getTypeID(), 0, std::move(key_elems),
+                                 std::move(key_padding), std::move(elems),
+                                 std::move(is_padding));
     }
-    return cache.get();
+    return cache;
   }
   // TODO: non-fixed sized vectors
   case llvm::Type::FixedVectorTyID: {
@@ -190,10 +231,10 @@ Type* llvm_type2alive(const llvm::Type *ty) {
       auto ety = llvm_type2alive(vty->getElementType());
       if (!ety || elems > 1024)
         return nullptr;
-      cache = make_unique<VectorType>("ty_" + to_string(type_id_counter++),
-                                      elems, *ety);
+      cache = intern<VectorType>(ty->getTypeID(), elems, { ety }, {}, elems,
+                                 *ety);
     }
-    return cache.get();
+    return cache;
   }
   case llvm::Type::ArrayTyID: {
     auto &cache = type_cache[ty];
@@ -212,13 +253,13 @@ Type* llvm_type2alive(const llvm::Type *ty) {
       Type *paddingTy = sz == sz_with_padding ? 0 :
           llvm_type2alive(llvm::IntegerType::get(aty->getContext(),
                                                  8 * (sz_with_padding - sz)));
-      cache = make_unique<ArrayType>("ty_" + to_string(type_id_counter++),
-                                     elems, *ety, paddingTy);
+      cache = intern<ArrayType>(ty->getTypeID(), elems, { ety, paddingTy }, {},
+                                elems, *ety, paddingTy);
     }
-    return cache.get();
+    return cache;
   }
   default:
-    *out << "ERROR: Unsupported type: " << *ty << '\n';
+    get_outs() << "ERROR: Unsupported type: " << *ty << '\n';
     return nullptr;
   }
 }
@@ -312,8 +353,10 @@ Value* get_operand(llvm::Value *v,
       // TODO: Global variable of opaque type is not supported.
       return nullptr;
 
+    unique_lock lock(llvm_mutex);
     unsigned size = DL->getTypeAllocSize(gv->getValueType());
     unsigned align = gv->getPointerAlignment(*DL).value();
+    lock.unlock();
     string name;
     if (!gv->hasName()) {
       unsigned id = 0;
@@ -376,7 +419,11 @@ Value* get_operand(llvm::Value *v,
   if (auto cnst = dyn_cast<llvm::ConstantDataSequential>(v)) {
     vector<Value*> vals;
     if (!fillAggregateValues(dynamic_cast<AggregateType *>(ty),
-            [&cnst](auto i) { return cnst->getElementAsConstant(i); }, vals))
+            [&cnst](auto i) {
+              // creates the constant in the (shared) LLVM context
+              lock_guard lock(llvm_mutex);
+              return cnst->getElementAsConstant(i);
+            }, vals))
       return nullptr;
 
     auto val = make_unique<AggregateValue>(*ty, std::move(vals));
@@ -388,7 +435,10 @@ Value* get_operand(llvm::Value *v,
   if (auto cnst = dyn_cast<llvm::ConstantAggregateZero>(v)) {
     vector<Value*> vals;
     if (!fillAggregateValues(dynamic_cast<AggregateType *>(ty),
-            [&cnst](auto i) { return cnst->getElementValue(i); }, vals))
+            [&cnst](auto i) {
+              lock_guard lock(llvm_mutex);
+              return cnst->getElementValue(i);
+            }, vals))
       return nullptr;
 
     auto val = make_unique<AggregateValue>(*ty, std::move(vals));
@@ -423,6 +473,7 @@ PRINT(llvm::Value)
 
 
 void init_llvm_utils(ostream &os, const llvm::DataLayout &dataLayout) {
+  lock_guard lock(llvm_mutex);
   out = &os;
   type_id_counter = 0;
   int_types.resize(65);
@@ -432,13 +483,21 @@ void init_llvm_utils(ostream &os, const llvm::DataLayout &dataLayout) {
 }
 
 ostream& get_outs() {
-  return *out;
+  return thread_out ? *thread_out : *out;
 }
 
 void set_outs(ostream &os) {
   out = &os;
 }
 
+void set_thread_outs(ostream *os) {
+  thread_out = os;
+}
+
+recursive_mutex& get_llvm_mutex() {
+  return llvm_mutex;
+}
+
 void reset_state(Function &f) {
   current_fn = &f;
   value_cache.clear();
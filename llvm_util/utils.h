@@ -5,6 +5,7 @@
 
 #include "ir/instr.h"
 #include <functional>
+#include <mutex>
 #include <ostream>
 #include <string>
 
@@ -32,6 +33,7 @@ IR::FastMathFlags parse_fmath(llvm::Instruction &i);
 IR::BasicBlock& getBB(const llvm::BasicBlock *bb);
 
 std::string value_name(const llvm::Value &v);
+void set_value_name(const llvm::Value &v, std::string &&name);
 void remove_value_name(const llvm::Value &v);
 
 IR::Type& get_int_type(unsigned bits);
@@ -53,6 +55,12 @@ void init_llvm_utils(std::ostream &os, const llvm::DataLayout &DL);
 
 std::ostream& get_outs();
 void set_outs(std::ostream &os);
+// Redirects the output of translations running in the current thread
+void set_thread_outs(std::ostream *os);
+
+// Must be held when creating or destroying LLVM values or types, since
+// functions of the same module may be translated concurrently
+std::recursive_mutex& get_llvm_mutex();
 
 void reset_state(IR::Function &f);
 }
@@ -12,6 +12,9 @@
 #include <limits>
 #include <memory>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 #include <z3.h>
 
 #define DEBUG_Z3_RC 0
@@ -44,7 +47,219 @@ static Z3_ast mkVar(const char *name, Z3_sort sort) {
   return Z3_mk_const(smt::ctx(), Z3_mk_string_symbol(smt::ctx(), name), sort);
 }
 
-static expr simplify_const(expr &&e) { return e.simplifyNoTimeout(); }
+static unsigned num_native_folds = 0;
+static unsigned num_z3_folds = 0;
+static unsigned num_simplify = 0;
+static unsigned num_simplify_hits = 0;
+
+// Memo of expr::simplify(), keyed by AST id. The key is kept alive so that
+// its id isn't reused.
+static unordered_map<unsigned, pair<expr, expr>> simplify_cache;
+static constexpr size_t simplify_cache_max_size = 1 << 16;
+
+namespace {
+// A BV (or bool, if bits == 0) constant of up to 64 bits. These are
+// hash-consed in an arena and referenced by exprs with a tagged index.
+// The Z3 AST is only created when needed.
+struct NativeConst {
+  uint64_t val;
+  unsigned bits;
+  Z3_ast ast = nullptr;
+};
+}
+
+// The arena isn't synchronized. Like the Z3 context, it belongs to the thread
+// that runs the verifier; e.g., llvm2alive_parallel's workers only build IR
+// and must not create exprs.
+static vector<NativeConst> native_consts;
+static unordered_map<uint64_t, unsigned> native_consts_map[65];
+static unsigned num_native_lowered = 0;
+#ifndef NDEBUG
+static thread::id native_consts_owner;
+#endif
+
+static void assert_native_consts_owner() {
+#ifndef NDEBUG
+  if (native_consts_owner == thread::id())
+    native_consts_owner = this_thread::get_id();
+  assert(native_consts_owner == this_thread::get_id());
+#endif
+}
+
+static uint64_t mask_bits(unsigned bits) {
+  return bits >= 64 ? UINT64_MAX : (UINT64_C(1) << bits) - 1;
+}
+
+static int64_t sext_bits(uint64_t v, unsigned bits) {
+  return bits >= 64 ? (int64_t)v : (int64_t)(v << (64 - bits)) >> (64 - bits);
+}
+
+static uintptr_t native_const(uint64_t val, unsigned bits) {
+  assert(bits <= 64);
+  assert_native_consts_owner();
+  val &= bits ? mask_bits(bits) : 1;
+  auto [I, inserted]
+    = native_consts_map[bits].try_emplace(val, native_consts.size());
+  if (inserted)
+    native_consts.push_back({ val, bits });
+  return ((uintptr_t)I->second << 1) | 1;
+}
+
+// Returns the native constant for a Z3 BV numeral of up to 64 bits or a
+// boolean constant, or 0 otherwise.
+static uintptr_t native_const(Z3_ast ast) {
+  uint64_t val;
+  unsigned bits;
+  switch (Z3_get_ast_kind(smt::ctx(), ast)) {
+  case Z3_NUMERAL_AST: {
+    auto sort = Z3_get_sort(smt::ctx(), ast);
+    if (Z3_get_sort_kind(smt::ctx(), sort) != Z3_BV_SORT)
+      return 0;
+    bits = Z3_get_bv_sort_size(smt::ctx(), sort);
+    if (bits > 64 || !Z3_get_numeral_uint64(smt::ctx(), ast, &val))
+      return 0;
+    break;
+  }
+  case Z3_APP_AST:
+    switch (Z3_get_bool_value(smt::ctx(), ast)) {
+    case Z3_L_TRUE:  val = 1; break;
+    case Z3_L_FALSE: val = 0; break;
+    default:         return 0;
+    }
+    bits = 0;
+    break;
+  default:
+    return 0;
+  }
+
+  auto ptr = native_const(val, bits);
+  auto &n = native_consts[ptr >> 1];
+  if (!n.ast) {
+    n.ast = ast;
+    Z3_inc_ref(smt::ctx(), ast);
+  }
+  return ptr;
+}
+
+static int z3_op_kind(Z3_ast(*op)(Z3_context, Z3_ast, Z3_ast)) {
+  static const pair<Z3_ast(*)(Z3_context, Z3_ast, Z3_ast), int> ops[] = {
+    { Z3_mk_bvadd, Z3_OP_BADD }, { Z3_mk_bvsub, Z3_OP_BSUB },
+    { Z3_mk_bvmul, Z3_OP_BMUL }, { Z3_mk_bvand, Z3_OP_BAND },
+    { Z3_mk_bvor, Z3_OP_BOR }, { Z3_mk_bvxor, Z3_OP_BXOR },
+    { Z3_mk_bvshl, Z3_OP_BSHL }, { Z3_mk_bvlshr, Z3_OP_BLSHR },
+    { Z3_mk_bvashr, Z3_OP_BASHR }, { Z3_mk_bvudiv, Z3_OP_BUDIV },
+    { Z3_mk_bvurem, Z3_OP_BUREM }, { Z3_mk_bvsdiv, Z3_OP_BSDIV },
+    { Z3_mk_bvsrem, Z3_OP_BSREM }, { Z3_mk_bvsmod, Z3_OP_BSMOD },
+    { Z3_mk_bvule, Z3_OP_ULEQ }, { Z3_mk_bvult, Z3_OP_ULT },
+    { Z3_mk_bvuge, Z3_OP_UGEQ }, { Z3_mk_bvugt, Z3_OP_UGT },
+    { Z3_mk_bvsle, Z3_OP_SLEQ }, { Z3_mk_bvslt, Z3_OP_SLT },
+    { Z3_mk_bvsge, Z3_OP_SGEQ }, { Z3_mk_bvsgt, Z3_OP_SGT },
+    { Z3_mk_eq, Z3_OP_EQ }, { Z3_mk_concat, Z3_OP_CONCAT },
+    { Z3_mk_implies, Z3_OP_IMPLIES }, { Z3_mk_xor, Z3_OP_XOR },
+  };
+  for (auto &[fn, kind] : ops) {
+    if (fn == op)
+      return kind;
+  }
+  return -1;
+}
+
+static int z3_op_kind(Z3_ast(*op)(Z3_context, Z3_ast)) {
+  if (op == Z3_mk_bvnot)
+    return Z3_OP_BNOT;
+  if (op == Z3_mk_bvneg)
+    return Z3_OP_BNEG;
+  if (op == Z3_mk_not)
+    return Z3_OP_NOT;
+  return -1;
+}
+
+// Evaluates a BV/bool operation over constants of bw <= 64 bits (booleans
+// are 0/1). Returns false if the operation isn't supported.
+static bool eval_native(int kind, unsigned nargs, const uint64_t *a,
+                        unsigned bw, uint64_t &r, bool &is_bool) {
+  int64_t sa = bw ? sext_bits(a[0], bw) : 0;
+  int64_t sb = bw ? sext_bits(a[1], bw) : 0;
+  is_bool = true;
+
+  switch (kind) {
+  case Z3_OP_NOT:      r = !a[0]; return true;
+  case Z3_OP_AND:      r = a[0] && (nargs == 1 || a[1]); return true;
+  case Z3_OP_OR:       r = a[0] || (nargs == 2 && a[1]); return true;
+  case Z3_OP_XOR:      r = nargs == 1 ? a[0] : a[0] != a[1]; return true;
+  case Z3_OP_IMPLIES:  r = !a[0] || a[1]; return true;
+  case Z3_OP_EQ:       r = a[0] == a[1]; return true;
+  case Z3_OP_DISTINCT: r = nargs == 1 || a[0] != a[1]; return true;
+  case Z3_OP_ULEQ:     r = a[0] <= a[1]; return true;
+  case Z3_OP_ULT:      r = a[0] <  a[1]; return true;
+  case Z3_OP_UGEQ:     r = a[0] >= a[1]; return true;
+  case Z3_OP_UGT:      r = a[0] >  a[1]; return true;
+  case Z3_OP_SLEQ:     r = sa <= sb; return true;
+  case Z3_OP_SLT:      r = sa <  sb; return true;
+  case Z3_OP_SGEQ:     r = sa >= sb; return true;
+  case Z3_OP_SGT:      r = sa >  sb; return true;
+  default:
+    break;
+  }
+
+  is_bool = false;
+  if (bw == 0)
+    return false;
+
+  switch (kind) {
+  case Z3_OP_BNEG: r = 0 - a[0]; break;
+  case Z3_OP_BNOT: r = ~a[0]; break;
+  case Z3_OP_BADD: r = a[0] + a[1]; break;
+  case Z3_OP_BSUB: r = a[0] - a[1]; break;
+  case Z3_OP_BMUL: r = a[0] * a[1]; break;
+  case Z3_OP_BAND: r = a[0] & a[1]; break;
+  case Z3_OP_BOR:  r = a[0] | a[1]; break;
+  case Z3_OP_BXOR: r = a[0] ^ a[1]; break;
+  case Z3_OP_BSHL:  r = a[1] >= bw ? 0 : a[0] << a[1]; break;
+  case Z3_OP_BLSHR: r = a[1] >= bw ? 0 : a[0] >> a[1]; break;
+  case Z3_OP_BASHR: r = sa >> (a[1] >= bw ? bw - 1 : a[1]); break;
+  // division by zero follows SMT-LIB's semantics
+  case Z3_OP_BUDIV:
+  case Z3_OP_BUDIV_I:
+    r = a[1] == 0 ? UINT64_MAX : a[0] / a[1];
+    break;
+  case Z3_OP_BUREM:
+  case Z3_OP_BUREM_I:
+    r = a[1] == 0 ? a[0] : a[0] % a[1];
+    break;
+  case Z3_OP_BSDIV:
+  case Z3_OP_BSDIV_I:
+    if (sb == 0)
+      r = sa < 0 ? 1 : UINT64_MAX;
+    else if (sb == -1)
+      r = 0 - a[0];
+    else
+      r = sa / sb;
+    break;
+  case Z3_OP_BSREM:
+  case Z3_OP_BSREM_I:
+    r = sb == 0 ? a[0] : sb == -1 ? 0 : sa % sb;
+    break;
+  case Z3_OP_BSMOD:
+  case Z3_OP_BSMOD_I: {
+    if (sb == 0) {
+      r = a[0];
+      break;
+    }
+    int64_t m = sb == -1 ? 0 : sa % sb;
+    if (m != 0 && (m < 0) != (sb < 0))
+      m += sb;
+    r = m;
+    break;
+  }
+  default:
+    return false;
+  }
+  r &= mask_bits(bw);
+  return true;
+}
+
+static expr simplify_const(expr &&e) { return e.foldConst(); }
 
 template <typename... Exprs>
 static expr simplify_const(expr &&e, const expr &input,
@@ -79,15 +294,22 @@ namespace smt {
 expr::expr(Z3_ast ast) noexcept : ptr((uintptr_t)ast) {
   static_assert(sizeof(Z3_ast) == sizeof(uintptr_t));
   assert(isZ3Ast() && isValid());
+  // constants that fit are always native, so that each constant has a single
+  // representation and can be compared without lowering it
+  if (auto native = native_const(ast)) {
+    ptr = native;
+    return;
+  }
   incRef();
 #if DEBUG_Z3_RC
   cout << "[Z3RC] newObj " << ast << ' ' << *this << '\n';
 #endif
 }
 
+expr::expr(bool val) noexcept : ptr(native_const(val, 0)) {}
+
 bool expr::isZ3Ast() const {
-  return true;
-  //return (ptr & 1) == 0;
+  return (ptr & 1) == 0;
 }
 
 Z3_ast expr::ast() const {
@@ -96,29 +318,41 @@ Z3_ast expr::ast() const {
   if (isZ3Ast())
     return (Z3_ast)ptr;
 
-  assert(0 && "TODO");
-  return 0;
+  // lower native constant
+  assert_native_consts_owner();
+  auto &n = native_consts[ptr >> 1];
+  if (!n.ast) {
+    n.ast = n.bits ? Z3_mk_unsigned_int64(ctx(), n.val, mkBVSort(n.bits))
+                   : (n.val ? Z3_mk_true(ctx()) : Z3_mk_false(ctx()));
+    Z3_inc_ref(ctx(), n.ast);
+    ++num_native_lowered;
+  }
+  return n.ast;
+}
+
+expr expr::mkNative(uint64_t val, unsigned bits) {
+  expr e;
+  e.ptr = native_const(val, bits);
+  return e;
+}
+
+bool expr::isNative(uint64_t &val, unsigned &bits) const {
+  if (!isValid() || isZ3Ast())
+    return false;
+  auto &n = native_consts[ptr >> 1];
+  val  = n.val;
+  bits = n.bits;
+  return true;
 }
 
-expr::expr(const expr &other) noexcept {
-  if (!other.isValid()) {
-    ptr = 0;
-  } else if (other.isZ3Ast()) {
-    ptr = other.ptr;
+expr::expr(const expr &other) noexcept : ptr(other.ptr) {
+  if (isValid() && isZ3Ast())
     incRef();
-  } else {
-    assert(0 && "TODO");
-  }
 }
 
 expr::~expr() noexcept {
-  if (isValid()) {
-    if (isZ3Ast()) {
-      decRef();
-    } else {
-      assert(0 && "TODO");
-    }
-  }
+  if (isValid() && isZ3Ast())
+    decRef();
 }
 
 void expr::incRef() {
@@ -145,14 +379,9 @@ void expr::operator=(expr &&other) {
 
 void expr::operator=(const expr &other) {
   this->~expr();
-  if (!other.isValid()) {
-    ptr = 0;
-  } else if (other.isZ3Ast()) {
-    ptr = other.ptr;
+  ptr = other.ptr;
+  if (isValid() && isZ3Ast())
     incRef();
-  } else {
-    assert(0 && "TODO");
-  }
 }
 
 Z3_sort expr::sort() const {
@@ -173,6 +402,10 @@ Z3_app expr::isApp() const {
 }
 
 Z3_app expr::isAppOf(int app_type) const {
+  // native constants are never applications of interesting operations
+  if (!isZ3Ast() && app_type != Z3_OP_BNUM && app_type != Z3_OP_TRUE &&
+      app_type != Z3_OP_FALSE)
+    return nullptr;
   auto app = isApp();
   if (!app)
     return nullptr;
@@ -180,37 +413,51 @@ Z3_app expr::isAppOf(int app_type) const {
   return Z3_get_decl_kind(ctx(), decl) == app_type ? app : nullptr;
 }
 
-Z3_ast expr::mkTrue() {
-  return Z3_mk_true(ctx());
-}
-
-Z3_ast expr::mkFalse() {
-  return Z3_mk_false(ctx());
-}
-
 expr expr::mkUInt(uint64_t n, Z3_sort sort) {
+  if (Z3_get_sort_kind(ctx(), sort) == Z3_BV_SORT) {
+    auto bits = Z3_get_bv_sort_size(ctx(), sort);
+    if (bits <= 64)
+      return mkNative(n, bits);
+  }
   return Z3_mk_unsigned_int64(ctx(), n, sort);
 }
 
 expr expr::mkUInt(uint64_t n, unsigned bits) {
-  return bits ? mkUInt(n, mkBVSort(bits)) : expr();
+  if (bits == 0)
+    return {};
+  return bits <= 64 ? mkNative(n, bits) : mkUInt(n, mkBVSort(bits));
 }
 
 expr expr::mkUInt(uint64_t n, const expr &type) {
   C2(type);
+  uint64_t val;
+  unsigned bits;
+  if (type.isNative(val, bits) && bits)
+    return mkNative(n, bits);
   return mkUInt(n, type.sort());
 }
 
 expr expr::mkInt(int64_t n, Z3_sort sort) {
+  if (Z3_get_sort_kind(ctx(), sort) == Z3_BV_SORT) {
+    auto bits = Z3_get_bv_sort_size(ctx(), sort);
+    if (bits <= 64)
+      return mkNative(n, bits);
+  }
   return Z3_mk_int64(ctx(), n, sort);
 }
 
 expr expr::mkInt(int64_t n, unsigned bits) {
-  return bits ? mkInt(n, mkBVSort(bits)) : expr();
+  if (bits == 0)
+    return {};
+  return bits <= 64 ? mkNative(n, bits) : mkInt(n, mkBVSort(bits));
 }
 
 expr expr::mkInt(int64_t n, const expr &type) {
   C2(type);
+  uint64_t val;
+  unsigned bits;
+  if (type.isNative(val, bits) && bits)
+    return mkNative(n, bits);
   return mkInt(n, type.sort());
 }
 
@@ -356,11 +603,15 @@ expr expr::IntUMax(unsigned bits) {
 
 bool expr::eq(const expr &rhs) const {
   C(rhs);
-  return ast() == rhs();
+  // Z3 ASTs and native constants are hash-consed, and constants that fit are
+  // never Z3 ASTs
+  return ptr == rhs.ptr;
 }
 
 bool expr::isConst() const {
   C();
+  if (!isZ3Ast())
+    return true;
   return Z3_is_numeral_ast(ctx(), ast()) ||
          Z3_get_bool_value(ctx(), ast()) != Z3_L_UNDEF;
 }
@@ -374,21 +625,37 @@ bool expr::isVar() const {
 
 bool expr::isBV() const {
   C();
+  uint64_t val;
+  unsigned bits;
+  if (isNative(val, bits))
+    return bits != 0;
   return Z3_get_sort_kind(ctx(), sort()) == Z3_BV_SORT;
 }
 
 bool expr::isBool() const {
   C();
+  uint64_t val;
+  unsigned bits;
+  if (isNative(val, bits))
+    return bits == 0;
   return Z3_get_sort_kind(ctx(), sort()) == Z3_BOOL_SORT;
 }
 
 bool expr::isTrue() const {
   C();
+  uint64_t val;
+  unsigned bits;
+  if (isNative(val, bits))
+    return bits == 0 && val;
   return Z3_get_bool_value(ctx(), ast()) == Z3_L_TRUE;
 }
 
 bool expr::isFalse() const {
   C();
+  uint64_t val;
+  unsigned bits;
+  if (isNative(val, bits))
+    return bits == 0 && !val;
   return Z3_get_bool_value(ctx(), ast()) == Z3_L_FALSE;
 }
 
@@ -404,6 +671,10 @@ bool expr::isOne() const {
 
 bool expr::isAllOnes() const {
   C();
+  uint64_t val;
+  unsigned bits;
+  if (isNative(val, bits))
+    return bits != 0 && val == mask_bits(bits);
   return eq(mkInt(-1, sort()));
 }
 
@@ -423,17 +694,30 @@ expr expr::isNegative() const {
 
 unsigned expr::bits() const {
   C();
+  uint64_t val;
+  unsigned bits;
+  if (isNative(val, bits) && bits)
+    return bits;
   return Z3_get_bv_sort_size(ctx(), sort());
 }
 
 bool expr::isUInt(uint64_t &n) const {
   C();
+  unsigned bits;
+  if (isNative(n, bits))
+    return bits != 0;
   return Z3_get_numeral_uint64(ctx(), ast(), &n);
 }
 
 bool expr::isInt(int64_t &n) const {
   C();
-  auto bw = bits();
+  uint64_t val;
+  unsigned bits;
+  if (isNative(val, bits)) {
+    n = sext_bits(val, bits);
+    return bits != 0;
+  }
+  auto bw = this->bits();
   if (bw > 64 || !Z3_get_numeral_int64(ctx(), ast(), &n))
     return false;
 
@@ -628,11 +912,19 @@ expr expr::binop_commutative(const expr &rhs,
 expr expr::binop_fold(const expr &rhs,
                       Z3_ast(*op)(Z3_context, Z3_ast, Z3_ast)) const {
   C(rhs);
+  if (auto r = foldNative(z3_op_kind(op), &rhs); r.isValid()) {
+    ++num_native_folds;
+    return r;
+  }
   return simplify_const(op(ctx(), ast(), rhs()), *this, rhs);
 }
 
 expr expr::unop_fold(Z3_ast(*op)(Z3_context, Z3_ast)) const {
   C();
+  if (auto r = foldNative(z3_op_kind(op), nullptr); r.isValid()) {
+    ++num_native_folds;
+    return r;
+  }
   return simplify_const(op(ctx(), ast()), *this);
 }
 
@@ -1979,16 +2271,117 @@ expr expr::mkLambda(const expr &var, const expr &val) {
 
 expr expr::simplify() const {
   C();
-  auto e = Z3_simplify(ctx(), ast());
+  if (!isZ3Ast())
+    return *this;
+  ++num_simplify;
+  auto id = this->id();
+  if (auto I = simplify_cache.find(id); I != simplify_cache.end()) {
+    ++num_simplify_hits;
+    return I->second.second;
+  }
+
+  expr e = Z3_simplify(ctx(), ast());
   // Z3_simplify returns null on timeout
-  return e ? e : *this;
+  if (!e.isValid())
+    return *this;
+
+  if (simplify_cache.size() >= simplify_cache_max_size)
+    simplify_cache.clear();
+  simplify_cache.emplace(id, make_pair(*this, e));
+  return e;
 }
 
 expr expr::simplifyNoTimeout() const {
   C();
+  if (!isZ3Ast())
+    return *this;
   return Z3_simplify_ex(ctx(), ast(), ctx.getNoTimeoutParam());
 }
 
+expr expr::foldConst() const {
+  C();
+  if (auto r = foldNative(); r.isValid()) {
+    ++num_native_folds;
+    return r;
+  }
+  ++num_z3_folds;
+  return simplifyNoTimeout();
+}
+
+expr expr::foldNative() const {
+  auto app = isApp();
+  if (!app)
+    return {};
+
+  unsigned nargs = Z3_get_app_num_args(ctx(), app);
+  if (nargs == 0 || nargs > 2)
+    return {};
+
+  uint64_t a[2] = { 0, 0 };
+  unsigned bw = 0, rhs_bw = 0;
+  for (unsigned i = 0; i < nargs; ++i) {
+    expr arg = Z3_get_app_arg(ctx(), app, i);
+    if (arg.isBool()) {
+      if (!arg.isConst())
+        return {};
+      a[i] = arg.isTrue();
+    } else if (!arg.isBV() || arg.bits() > 64 || !arg.isUInt(a[i])) {
+      return {};
+    } else {
+      (i == 0 ? bw : rhs_bw) = arg.bits();
+    }
+  }
+
+  auto decl = Z3_get_app_decl(ctx(), app);
+  auto kind = Z3_get_decl_kind(ctx(), decl);
+  uint64_t r;
+  switch (kind) {
+  case Z3_OP_CONCAT:
+    if (nargs != 2 || bw + rhs_bw > 64)
+      return {};
+    return mkNative((a[0] << rhs_bw) | a[1], bw + rhs_bw);
+  case Z3_OP_EXTRACT: {
+    unsigned high = Z3_get_decl_int_parameter(ctx(), decl, 0);
+    unsigned low  = Z3_get_decl_int_parameter(ctx(), decl, 1);
+    return mkNative(a[0] >> low, high - low + 1);
+  }
+  case Z3_OP_ZERO_EXT:
+  case Z3_OP_SIGN_EXT: {
+    unsigned amount = Z3_get_decl_int_parameter(ctx(), decl, 0);
+    if (bw + amount > 64)
+      return {};
+    r = kind == Z3_OP_ZERO_EXT ? a[0] : sext_bits(a[0], bw);
+    return mkNative(r, bw + amount);
+  }
+  default:
+    break;
+  }
+
+  bool is_bool;
+  if (!eval_native(kind, nargs, a, bw, r, is_bool))
+    return {};
+  return is_bool ? expr(r != 0) : mkNative(r, bw);
+}
+
+expr expr::foldNative(int z3op, const expr *rhs) const {
+  uint64_t a[2] = { 0, 0 };
+  unsigned bw, rhs_bw = 0;
+  if (!isNative(a[0], bw) || (rhs && !rhs->isNative(a[1], rhs_bw)))
+    return {};
+
+  if (z3op == Z3_OP_CONCAT) {
+    if (bw + rhs_bw > 64)
+      return {};
+    return mkNative((a[0] << rhs_bw) | a[1], bw + rhs_bw);
+  }
+
+  uint64_t r;
+  bool is_bool;
+  if (!eval_native(z3op, rhs ? 2 : 1, a, bw, r, is_bool))
+    return {};
+  return is_bool ? expr(r != 0) : mkNative(r, bw);
+}
+
 expr expr::foldTopLevel() const {
   expr cond, then, els;
   if (isIf(cond, then, els))
@@ -2006,7 +2399,7 @@ expr expr::foldTopLevel() const {
         break;
     }
     if (is_const)
-      return simplifyNoTimeout();
+      return foldConst();
   }
   return *this;
 }
@@ -2054,7 +2447,7 @@ set<expr> expr::vars() const {
   return vars({ this });
 }
 
-set<expr> expr::vars(const vector<const expr*> &exprs) {
+set<expr> expr::vars(const vector<const expr*> &exprs, bool uninterp_fns) {
   set<expr> result;
   vector<Z3_ast> todo;
   unordered_set<Z3_ast> seen;
@@ -2089,7 +2482,14 @@ set<expr> expr::vars(const vector<const expr*> &exprs) {
 
       auto app = Z3_to_app(ctx(), ast);
       auto num_args = Z3_get_app_num_args(ctx(), app);
-      if (num_args == 0) { // it's a variable
+      if (uninterp_fns) {
+        auto decl = Z3_get_app_decl(ctx(), app);
+        if (Z3_get_decl_kind(ctx(), decl) == Z3_OP_UNINTERPRETED)
+          result.emplace(num_args == 0 ? expr(ast)
+                                       : expr(Z3_func_decl_to_ast(ctx(), decl)));
+        if (num_args == 0)
+          continue;
+      } else if (num_args == 0) { // it's a variable
         result.emplace(expr(ast));
         continue;
       }
@@ -2190,16 +2590,55 @@ ostream& operator<<(ostream &os, const expr &e) {
 strong_ordering expr::operator<=>(const expr &rhs) const {
   if (ptr == rhs.ptr || !isValid() || !rhs.isValid())
     return ptr <=> rhs.ptr;
+  // native constants go first, by arena index, so they aren't lowered
+  bool native = !isZ3Ast(), rhs_native = !rhs.isZ3Ast();
+  if (native && rhs_native)
+    return ptr <=> rhs.ptr;
+  if (native || rhs_native)
+    return rhs_native <=> native;
   // so iterators are stable
   return id() <=> rhs.id();
 }
 
 unsigned expr::id() const {
+  // native constants take ids from the top, away from Z3's
+  if (!isZ3Ast())
+    return UINT_MAX - (ptr >> 1);
   return Z3_get_ast_id(ctx(), ast());
 }
 
 unsigned expr::hash() const {
+  if (!isZ3Ast()) {
+    auto &n = native_consts[ptr >> 1];
+    return (unsigned)std::hash<uint64_t>()(n.val) * 31 + n.bits;
+  }
   return Z3_get_ast_hash(ctx(), ast());
 }
 
+void expr_reset_cache() {
+  simplify_cache.clear();
+  for (auto &n : native_consts) {
+    if (n.ast)
+      Z3_dec_ref(ctx(), n.ast);
+  }
+  native_consts.clear();
+  for (auto &m : native_consts_map)
+    m.clear();
+#ifndef NDEBUG
+  native_consts_owner = thread::id();
+#endif
+}
+
+void expr_print_stats(ostream &os) {
+  float hit_pc = num_simplify == 0 ? 0
+                   : (num_simplify_hits * 100.0) / num_simplify;
+  os << "Num const folds (native):  " << num_native_folds << "\n"
+        "Num const folds (Z3):      " << num_z3_folds << "\n"
+        "Num simplify:              " << num_simplify << "\n"
+        "Num simplify cache hits:   " << num_simplify_hits << " (" << hit_pc
+     << "%)\n"
+        "Num native consts:         " << native_consts.size() << "\n"
+        "Num native consts lowered: " << num_native_lowered << '\n';
+}
+
 }
@@ -50,12 +50,19 @@ class expr {
 
   bool alwaysFalse() const { return false; }
 
-  static Z3_ast mkTrue();
-  static Z3_ast mkFalse();
   static expr mkUInt(uint64_t n, Z3_sort sort);
   static expr mkInt(int64_t n, Z3_sort sort);
   static expr mkConst(Z3_decl decl);
 
+  // Constants of up to 64 bits are Alive-owned nodes (tagged pointers)
+  // that are only lowered to Z3 when their AST is needed
+  static expr mkNative(uint64_t val, unsigned bits);
+  bool isNative(uint64_t &val, unsigned &bits) const;
+
+  // evaluates BV/bool ops over constants of up to 64 bits without Z3
+  expr foldNative() const;
+  expr foldNative(int z3op, const expr *rhs) const;
+
   bool isUnOp(expr &a, int z3op) const;
   bool isBinOp(expr &a, expr &b, int z3op) const;
   bool isTernaryOp(expr &a, expr &b, expr &c, int z3op) const;
@@ -68,7 +75,7 @@ public:
   }
 
   expr(const expr &other) noexcept;
-  expr(bool val) noexcept : expr(val ? mkTrue() : mkFalse()) {}
+  expr(bool val) noexcept;
   ~expr() noexcept;
 
   void operator=(expr &&other);
@@ -338,6 +345,8 @@ public:
 
   expr simplify() const;
   expr simplifyNoTimeout() const;
+  // simplify an application whose arguments are all constants
+  expr foldConst() const;
 
   expr foldTopLevel() const;
 
@@ -349,7 +358,10 @@ public:
   expr subst(const std::vector<expr> &repls) const;
 
   std::set<expr> vars() const;
-  static std::set<expr> vars(const std::vector<const expr*> &exprs);
+  // with uninterp_fns, returns only uninterpreted constants, plus the
+  // declarations of uninterpreted functions (as exprs)
+  static std::set<expr> vars(const std::vector<const expr*> &exprs,
+                             bool uninterp_fns = false);
 
   std::set<expr> leafs(unsigned max = 64) const;
 
@@ -392,4 +404,8 @@ static expr mkIf_fold_fn(const expr &cond, T1 &&a, T2 &&b) {
   return expr::mkIf(cond, a(), b());
 }
 
+// drops memoized simplifications; must be called before the context is reset
+void expr_reset_cache();
+void expr_print_stats(std::ostream &os);
+
 }
@@ -33,6 +33,9 @@ public:
   expr operator()() const;
   operator bool() const;
   bool isTrue() const { return exprs.empty(); }
+  auto begin() const { return exprs.begin(); }
+  auto end() const { return exprs.end(); }
+  size_t size() const { return exprs.size(); }
   friend std::ostream &operator<<(std::ostream &os, const AndExpr &e);
 };
 
@@ -3,8 +3,11 @@
 
 #include "smt/smt.h"
 #include "smt/ctx.h"
+#include "smt/expr.h"
 #include "smt/solver.h"
+#include "util/compiler.h"
 #include "util/version.h"
+#include <algorithm>
 #include <cstdint>
 #include <string>
 #include <z3.h>
@@ -35,6 +38,7 @@ void smt_initializer::init() {
 }
 
 void smt_initializer::destroy() {
+  expr_reset_cache();
   solver_destroy();
   ctx.destroy();
 }
@@ -66,12 +70,46 @@ void set_memory_limit(uint64_t limit) {
   z3_memory_limit = limit;
 }
 
+static MemoryPressure max_pressure = MemoryPressure::None;
+
+MemoryPressure memory_pressure() {
+  auto size = Z3_get_estimated_alloc_size();
+  auto p = size >= z3_memory_limit         ? MemoryPressure::Abort
+         : size >= z3_memory_limit / 4 * 3 ? MemoryPressure::Degrade
+         : size >= z3_memory_limit / 2     ? MemoryPressure::Release
+                                           : MemoryPressure::None;
+  max_pressure = max(max_pressure, p);
+  return p;
+}
+
+MemoryPressure max_memory_pressure() {
+  return max_pressure;
+}
+
+void reset_memory_pressure() {
+  max_pressure = MemoryPressure::None;
+}
+
+const char* memory_pressure_str(MemoryPressure p) {
+  switch (p) {
+  case MemoryPressure::None:    return "none";
+  case MemoryPressure::Release: return "release";
+  case MemoryPressure::Degrade: return "degrade";
+  case MemoryPressure::Abort:   return "abort";
+  }
+  UNREACHABLE();
+}
+
 bool hit_memory_limit() {
-  return Z3_get_estimated_alloc_size() >= z3_memory_limit;
+  return memory_pressure() == MemoryPressure::Abort;
 }
 
 bool hit_half_memory_limit() {
-  return Z3_get_estimated_alloc_size() >= (z3_memory_limit / 2);
+  return memory_pressure() >= MemoryPressure::Release;
+}
+
+uint64_t get_memory_usage() {
+  return Z3_get_estimated_alloc_size();
 }
 
 void start_logging(const char *path) {
@@ -24,8 +24,22 @@ void set_random_seed(std::string seed);
 const char *get_random_seed();
 
 void set_memory_limit(uint64_t limit);
+
+// Tiers of memory pressure, relative to the memory limit. From half of the
+// limit, no longer needed data should be released; from three quarters,
+// cheaper (but less precise) encodings should be used; at the limit, the
+// function is skipped.
+enum class MemoryPressure { None, Release, Degrade, Abort };
+MemoryPressure memory_pressure();
+// highest tier seen since the last reset
+MemoryPressure max_memory_pressure();
+void reset_memory_pressure();
+const char* memory_pressure_str(MemoryPressure p);
+
 bool hit_memory_limit();
 bool hit_half_memory_limit();
+// estimate of the memory allocated by Z3, in bytes
+uint64_t get_memory_usage();
 
 void start_logging(const char *path = "z3_log.txt");
 
@@ -381,6 +381,33 @@ void solver_print_stats(ostream &os) {
         "Num errors:  " << num_errors << " (" << error_pc << "%)\n"
         "Num SAT:     " << num_sats << " (" << sat_pc << "%)\n"
         "Num UNSAT:   " << num_unsats << " (" << unsat_pc << "%)\n";
+  expr_print_stats(os);
+}
+
+SolverStats SolverStats::operator-(const SolverStats &rhs) const {
+  SolverStats r;
+  r.queries  = queries - rhs.queries;
+  r.skips    = skips - rhs.skips;
+  r.invalid  = invalid - rhs.invalid;
+  r.trivial  = trivial - rhs.trivial;
+  r.sats     = sats - rhs.sats;
+  r.unsats   = unsats - rhs.unsats;
+  r.timeouts = timeouts - rhs.timeouts;
+  r.errors   = errors - rhs.errors;
+  return r;
+}
+
+SolverStats solver_get_stats() {
+  SolverStats r;
+  r.queries  = num_queries;
+  r.skips    = num_skips;
+  r.invalid  = num_invalid;
+  r.trivial  = num_trivial;
+  r.sats     = num_sats;
+  r.unsats   = num_unsats;
+  r.timeouts = num_timeout;
+  r.errors   = num_errors;
+  return r;
 }
 
 
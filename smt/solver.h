@@ -125,6 +125,21 @@ void solver_print_queries(bool yes);
 void solver_tactic_verbose(bool yes);
 void solver_print_stats(std::ostream &os);
 
+struct SolverStats {
+  unsigned queries = 0;
+  unsigned skips = 0;
+  unsigned invalid = 0;
+  unsigned trivial = 0;
+  unsigned sats = 0;
+  unsigned unsats = 0;
+  unsigned timeouts = 0;
+  unsigned errors = 0;
+
+  SolverStats operator-(const SolverStats &rhs) const;
+};
+
+SolverStats solver_get_stats();
+
 
 struct EnableSMTQueriesTMP {
   bool old;
@@ -0,0 +1,17 @@
+define i8 @src(i8 %x, i8* %p) {
+  %a = add i8 %x, 1
+  %b = add i8 %x, 1
+  %d = sub i8 %a, %b
+  %k = mul i8 20, 13
+  %c = icmp slt i8 %k, 0
+  %s = select i1 %c, i8 %k, i8 %x
+  %q = bitcast i8* %p to i8*
+  store i8 %s, i8* %q
+  %r = add i8 %d, %k
+  ret i8 %r
+}
+
+define i8 @tgt(i8 %x, i8* %p) {
+  store i8 %x, i8* %p
+  ret i8 4
+}
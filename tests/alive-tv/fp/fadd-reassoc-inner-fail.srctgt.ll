@@ -0,0 +1,13 @@
+define float @src(float noundef %a, float noundef %b, float noundef %c) {
+  %t1 = fadd float %a, %b
+  %t = fadd reassoc float %t1, %c
+  ret float %t
+}
+
+define float @tgt(float noundef %a, float noundef %b, float noundef %c) {
+  %t1 = fadd reassoc float %b, %c
+  %t = fadd reassoc float %a, %t1
+  ret float %t
+}
+
+; ERROR: Couldn't prove the correctness of the transformation
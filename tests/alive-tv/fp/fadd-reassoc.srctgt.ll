@@ -0,0 +1,11 @@
+define float @src(float noundef %a, float noundef %b, float noundef %c) {
+  %t1 = fadd reassoc float %a, %b
+  %t = fadd reassoc float %t1, %c
+  ret float %t
+}
+
+define float @tgt(float noundef %a, float noundef %b, float noundef %c) {
+  %t1 = fadd reassoc float %c, %b
+  %t = fadd reassoc float %a, %t1
+  ret float %t
+}
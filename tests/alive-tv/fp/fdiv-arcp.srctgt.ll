@@ -0,0 +1,10 @@
+define float @src(float noundef %a, float noundef %b) {
+  %t = fdiv arcp float %a, %b
+  ret float %t
+}
+
+define float @tgt(float noundef %a, float noundef %b) {
+  %r = fdiv arcp float 1.0, %b
+  %t = fmul arcp float %a, %r
+  ret float %t
+}
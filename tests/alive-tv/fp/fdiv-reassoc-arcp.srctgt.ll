@@ -0,0 +1,13 @@
+; (a * b) / c -> a * (b * (1 / c))
+define float @src(float noundef %a, float noundef %b, float noundef %c) {
+  %x = fmul reassoc arcp float %a, %b
+  %t = fdiv reassoc arcp float %x, %c
+  ret float %t
+}
+
+define float @tgt(float noundef %a, float noundef %b, float noundef %c) {
+  %r = fdiv reassoc arcp float 1.0, %c
+  %z = fmul reassoc arcp float %b, %r
+  %t = fmul reassoc arcp float %a, %z
+  ret float %t
+}
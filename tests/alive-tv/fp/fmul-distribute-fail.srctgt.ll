@@ -0,0 +1,14 @@
+define float @src(float noundef %a, float noundef %b, float noundef %c) {
+  %t1 = fadd float %b, %c
+  %t = fmul reassoc float %a, %t1
+  ret float %t
+}
+
+define float @tgt(float noundef %a, float noundef %b, float noundef %c) {
+  %x = fmul reassoc float %a, %b
+  %y = fmul reassoc float %a, %c
+  %t = fadd reassoc float %x, %y
+  ret float %t
+}
+
+; ERROR: Couldn't prove the correctness of the transformation
@@ -0,0 +1,12 @@
+define float @src(float noundef %a, float noundef %b, float noundef %c) {
+  %t1 = fadd reassoc nsz float %b, %c
+  %t = fmul reassoc nsz float %a, %t1
+  ret float %t
+}
+
+define float @tgt(float noundef %a, float noundef %b, float noundef %c) {
+  %x = fmul reassoc nsz float %a, %b
+  %y = fmul reassoc nsz float %a, %c
+  %t = fadd reassoc nsz float %x, %y
+  ret float %t
+}
@@ -0,0 +1,12 @@
+; the rewritten ops take the flags of the outer one
+define float @src(float noundef %a, float noundef %b, float noundef %c) {
+  %x = fmul reassoc float %a, %b
+  %t = fmul reassoc arcp float %x, %c
+  ret float %t
+}
+
+define float @tgt(float noundef %a, float noundef %b, float noundef %c) {
+  %x = fmul reassoc arcp float %b, %c
+  %t = fmul reassoc arcp float %a, %x
+  ret float %t
+}
@@ -0,0 +1,12 @@
+@a = global i8 0
+@b = global i8 0
+
+define <2 x i8*> @src(<2 x i8*>* %p) {
+  store <2 x i8*> <i8* @a, i8* @b>, <2 x i8*>* %p
+  ret <2 x i8*> <i8* @a, i8* @b>
+}
+
+define <2 x i8*> @tgt(<2 x i8*>* %p) {
+  store <2 x i8*> <i8* @a, i8* @b>, <2 x i8*>* %p
+  ret <2 x i8*> <i8* @a, i8* @b>
+}
@@ -0,0 +1,43 @@
+; Copy ints into a block holding pointers, and then copy it all back
+define i1 @src(i8* noundef %q, i64 noundef %x) {
+  ret i1 true
+}
+
+define i1 @tgt(i8* noundef %q, i64 noundef %x) {
+  %a = alloca [2 x i64], align 8
+  %b = alloca [2 x i8*], align 8
+  %a0 = bitcast [2 x i64]* %a to i64*
+  %a1 = getelementptr inbounds [2 x i64], [2 x i64]* %a, i64 0, i64 1
+  store i64 %x, i64* %a0, align 8
+  store i64 0, i64* %a1, align 8
+  %b0 = getelementptr inbounds [2 x i8*], [2 x i8*]* %b, i64 0, i64 0
+  %b1 = getelementptr inbounds [2 x i8*], [2 x i8*]* %b, i64 0, i64 1
+  store i8* %q, i8** %b0, align 8
+  store i8* %q, i8** %b1, align 8
+
+  %a1.i8 = bitcast i64* %a1 to i8*
+  %b1.i8 = bitcast i8** %b1 to i8*
+  call void @llvm.memcpy.p0i8.p0i8.i64(i8* align 8 %b1.i8, i8* align 8 %a1.i8, i64 8, i1 false)
+  %b1.int = bitcast i8** %b1 to i64*
+  %v1 = load i64, i64* %b1.int, align 8
+  %c1 = icmp eq i64 %v1, 0
+
+  %a.i8 = bitcast [2 x i64]* %a to i8*
+  %b.i8 = bitcast [2 x i8*]* %b to i8*
+  call void @llvm.memcpy.p0i8.p0i8.i64(i8* align 8 %a.i8, i8* align 8 %b.i8, i64 16, i1 false)
+  %a0.ptr = bitcast i64* %a0 to i8**
+  %v2 = load i8*, i8** %a0.ptr, align 8
+  %c2 = icmp eq i8* %v2, %q
+  %v3 = load i64, i64* %a1, align 8
+  %c3 = icmp eq i64 %v3, 0
+  %a1.ptr = bitcast i64* %a1 to i8**
+  %v4 = load i8*, i8** %a1.ptr, align 8
+  %c4 = icmp eq i8* %v4, null
+
+  %r1 = and i1 %c1, %c2
+  %r2 = and i1 %c3, %c4
+  %r = and i1 %r1, %r2
+  ret i1 %r
+}
+
+declare void @llvm.memcpy.p0i8.p0i8.i64(i8*, i8*, i64, i1)
@@ -0,0 +1,27 @@
+; The block holds only ints on one path and a pointer on the other
+define i1 @src(i1 noundef %c, i8* noundef %q) {
+  ret i1 true
+}
+
+define i1 @tgt(i1 noundef %c, i8* noundef %q) {
+entry:
+  %p = alloca i64, align 8
+  store i64 0, i64* %p, align 8
+  br i1 %c, label %then, label %join
+
+then:
+  %p.ptr = bitcast i64* %p to i8**
+  store i8* %q, i8** %p.ptr, align 8
+  br label %join
+
+join:
+  %pp = bitcast i64* %p to i8**
+  %v = load i8*, i8** %pp, align 8
+  %i = load i64, i64* %p, align 8
+  %is.q = icmp eq i8* %v, %q
+  %is.null = icmp eq i8* %v, null
+  %is.zero = icmp eq i64 %i, 0
+  %zero = and i1 %is.zero, %is.null
+  %r = select i1 %c, i1 %is.q, i1 %zero
+  ret i1 %r
+}
@@ -0,0 +1,16 @@
+; A non-zero int loaded as a pointer is poison
+define i1 @src(i8* noundef %q, i64 noundef %x) {
+  ret i1 true
+}
+
+define i1 @tgt(i8* noundef %q, i64 noundef %x) {
+  %p = alloca i64, align 8
+  %pp = bitcast i64* %p to i8**
+  store i8* %q, i8** %pp, align 8
+  store i64 %x, i64* %p, align 8
+  %v = load i8*, i8** %pp, align 8
+  %c = icmp eq i8* %v, null
+  ret i1 %c
+}
+
+; ERROR: Target is more poisonous than source
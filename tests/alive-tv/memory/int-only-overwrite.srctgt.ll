@@ -0,0 +1,20 @@
+; Overwriting a pointer with an int switches the block back to int-only
+define i1 @src(i8* noundef %q) {
+  ret i1 true
+}
+
+define i1 @tgt(i8* noundef %q) {
+  %p = alloca i64, align 8
+  %pp = bitcast i64* %p to i8**
+  store i8* %q, i8** %pp, align 8
+  %v1 = load i8*, i8** %pp, align 8
+  %c1 = icmp eq i8* %v1, %q
+  store i64 0, i64* %p, align 8
+  %i = load i64, i64* %p, align 8
+  %c2 = icmp eq i64 %i, 0
+  %v2 = load i8*, i8** %pp, align 8
+  %c3 = icmp eq i8* %v2, null
+  %c = and i1 %c1, %c2
+  %r = and i1 %c, %c3
+  ret i1 %r
+}
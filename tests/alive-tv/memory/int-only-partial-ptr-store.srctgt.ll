@@ -0,0 +1,24 @@
+; A pointer stored into half of a block that held only ints so far
+define i1 @src(i8* noundef %q) {
+  ret i1 true
+}
+
+define i1 @tgt(i8* noundef %q) {
+  %p = alloca [2 x i64], align 8
+  %lo = bitcast [2 x i64]* %p to i64*
+  %hi = getelementptr inbounds [2 x i64], [2 x i64]* %p, i64 0, i64 1
+  store i64 0, i64* %lo, align 8
+  store i64 0, i64* %hi, align 8
+  %hi.ptr = bitcast i64* %hi to i8**
+  store i8* %q, i8** %hi.ptr, align 8
+  %lo.int = load i64, i64* %lo, align 8
+  %lo.ptr = bitcast i64* %lo to i8**
+  %lo.p = load i8*, i8** %lo.ptr, align 8
+  %hi.p = load i8*, i8** %hi.ptr, align 8
+  %c1 = icmp eq i64 %lo.int, 0
+  %c2 = icmp eq i8* %lo.p, null
+  %c3 = icmp eq i8* %hi.p, %q
+  %c = and i1 %c1, %c2
+  %r = and i1 %c, %c3
+  ret i1 %r
+}
@@ -0,0 +1,31 @@
+declare void @llvm.memcpy.p0i8.p0i8.i64(i8*, i8*, i64, i1)
+
+define i64 @src(i64 %a, i64 %b) {
+  %p = alloca [64 x i8], align 8
+  %q = alloca [64 x i8], align 8
+  %r = alloca [64 x i8], align 8
+  %p8 = bitcast [64 x i8]* %p to i8*
+  %q8 = bitcast [64 x i8]* %q to i8*
+  %r8 = bitcast [64 x i8]* %r to i8*
+  %pa = bitcast [64 x i8]* %p to i64*
+  store i64 %a, i64* %pa, align 8
+  %p40 = getelementptr inbounds i8, i8* %p8, i64 40
+  %pb = bitcast i8* %p40 to i64*
+  store i64 %b, i64* %pb, align 8
+  call void @llvm.memcpy.p0i8.p0i8.i64(i8* %q8, i8* %p8, i64 64, i1 0)
+  %r8_8 = getelementptr inbounds i8, i8* %r8, i64 8
+  call void @llvm.memcpy.p0i8.p0i8.i64(i8* %r8_8, i8* %q8, i64 48, i1 0)
+  %q40 = getelementptr inbounds i8, i8* %q8, i64 40
+  %qb = bitcast i8* %q40 to i64*
+  %v1 = load i64, i64* %qb, align 8
+  %r48 = getelementptr inbounds i8, i8* %r8, i64 48
+  %rb = bitcast i8* %r48 to i64*
+  %v2 = load i64, i64* %rb, align 8
+  %s = sub i64 %v1, %v2
+  %x = add i64 %s, %b
+  ret i64 %x
+}
+
+define i64 @tgt(i64 %a, i64 %b) {
+  ret i64 %b
+}
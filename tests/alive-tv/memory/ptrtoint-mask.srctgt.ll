@@ -0,0 +1,11 @@
+define i64 @src() {
+  %p = alloca i32, align 16
+  %i = ptrtoint i32* %p to i64
+  %m = and i64 %i, 15
+  ret i64 %m
+}
+
+define i64 @tgt() {
+  %p = alloca i32, align 16
+  ret i64 0
+}
@@ -0,0 +1,18 @@
+; TEST-ARGS: -split-memory-check
+; ERROR: Mismatch in memory
+
+@g = global i8 0
+
+define void @src(i8* %p, i8* %q) {
+  store i8 1, i8* %p
+  store i8 2, i8* %q
+  store i8 3, i8* @g
+  ret void
+}
+
+define void @tgt(i8* %p, i8* %q) {
+  store i8 1, i8* %p
+  store i8 2, i8* %q
+  store i8 4, i8* @g
+  ret void
+}
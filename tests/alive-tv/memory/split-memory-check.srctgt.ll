@@ -0,0 +1,17 @@
+; TEST-ARGS: -split-memory-check
+
+@g = global i8 0
+
+define void @src(i8* %p, i8* %q) {
+  store i8 1, i8* %p
+  store i8 2, i8* %q
+  store i8 3, i8* @g
+  ret void
+}
+
+define void @tgt(i8* %p, i8* %q) {
+  store i8 1, i8* %p
+  store i8 2, i8* %q
+  store i8 3, i8* @g
+  ret void
+}
@@ -0,0 +1,16 @@
+target datalayout = "e-m:o-i64:64-f80:128-n8:16:32:64-S128"
+
+@g = global [16 x i8] undef
+
+define i1 @src() {
+  %p = bitcast [16 x i8]* @g to i8*
+  %l = call i64 @strlen(i8* %p)
+  %c = icmp ult i64 %l, 16
+  ret i1 %c
+}
+
+define i1 @tgt() {
+  ret i1 true
+}
+
+declare i64 @strlen(i8*)
@@ -0,0 +1,30 @@
+; Reordered blocks aren't a renaming; must be fully verified
+
+define i8 @src(i8 %a, i1 %c) {
+entry:
+  br i1 %c, label %then, label %exit
+
+then:
+  %y = mul i8 %a, 3
+  br label %exit
+
+exit:
+  %r = phi i8 [ %a, %entry ], [ %y, %then ]
+  ret i8 %r
+}
+
+define i8 @tgt(i8 %a, i1 %c) {
+entry:
+  br i1 %c, label %then, label %exit
+
+exit:
+  %r = phi i8 [ %a, %entry ], [ %y, %then ]
+  ret i8 %r
+
+then:
+  %y = mul i8 %a, 3
+  br label %exit
+}
+
+; CHECK: Transformation seems to be correct!
+; CHECK-NOT: (syntactically equal)
@@ -0,0 +1,18 @@
+; Reordered instructions aren't a renaming; must be fully verified
+
+define i8 @src(i8 %a) {
+  %x = add i8 %a, 1
+  %y = mul i8 %a, 3
+  %r = xor i8 %x, %y
+  ret i8 %r
+}
+
+define i8 @tgt(i8 %a) {
+  %y = mul i8 %a, 3
+  %x = add i8 %a, 1
+  %r = xor i8 %x, %y
+  ret i8 %r
+}
+
+; CHECK: Transformation seems to be correct!
+; CHECK-NOT: (syntactically equal)
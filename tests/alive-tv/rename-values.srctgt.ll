@@ -0,0 +1,28 @@
+define i8 @src(i8 %a, i1 %c) {
+entry:
+  %x = add i8 %a, 1
+  br i1 %c, label %then, label %exit
+
+then:
+  %y = mul i8 %x, 3
+  br label %exit
+
+exit:
+  %r = phi i8 [ %x, %entry ], [ %y, %then ]
+  ret i8 %r
+}
+
+define i8 @tgt(i8 %0, i1 %1) {
+  %3 = add i8 %0, 1
+  br i1 %1, label %4, label %6
+
+4:
+  %5 = mul i8 %3, 3
+  br label %6
+
+6:
+  %7 = phi i8 [ %3, %2 ], [ %5, %4 ]
+  ret i8 %7
+}
+
+; CHECK: Transformation seems to be correct! (syntactically equal)
@@ -0,0 +1,12 @@
+; ERROR: Value mismatch
+
+define i1 @src(float %f) {
+  ret i1 true
+}
+
+define i1 @tgt(float %f) {
+  %a = bitcast float %f to i32
+  %b = bitcast float %f to i32
+  %c = icmp eq i32 %a, %b
+  ret i1 %c
+}
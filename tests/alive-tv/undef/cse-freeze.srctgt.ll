@@ -0,0 +1,12 @@
+; ERROR: Value mismatch
+
+define i8 @src(i8 %x) {
+  ret i8 0
+}
+
+define i8 @tgt(i8 %x) {
+  %a = freeze i8 undef
+  %b = freeze i8 undef
+  %r = sub i8 %a, %b
+  ret i8 %r
+}
@@ -0,0 +1,14 @@
+; ERROR: Value mismatch
+
+define i1 @src(i1 %c) {
+  ret i1 true
+}
+
+define i1 @tgt(i1 %c) {
+  %a = select nsz i1 %c, float 0.0, float 0.0
+  %b = select nsz i1 %c, float 0.0, float 0.0
+  %da = fdiv float 1.0, %a
+  %db = fdiv float 1.0, %b
+  %r = fcmp oeq float %da, %db
+  ret i1 %r
+}
@@ -0,0 +1,13 @@
+; Each use of undef may take a different value, so %a and %b can't be merged
+; ERROR: Target's return value is more undefined
+
+define i8 @src(i8 %x) {
+  ret i8 0
+}
+
+define i8 @tgt(i8 %x) {
+  %a = add i8 undef, %x
+  %b = add i8 undef, %x
+  %r = sub i8 %a, %b
+  ret i8 %r
+}
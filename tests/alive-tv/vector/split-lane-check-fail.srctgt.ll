@@ -0,0 +1,12 @@
+; TEST-ARGS: -split-lane-check
+; ERROR: Value mismatch
+
+define <4 x i8> @src(<4 x i8> %x, i8 %a) {
+  %v = insertelement <4 x i8> %x, i8 %a, i32 1
+  ret <4 x i8> %v
+}
+
+define <4 x i8> @tgt(<4 x i8> %x, i8 %a) {
+  %v = insertelement <4 x i8> %x, i8 %a, i32 2
+  ret <4 x i8> %v
+}
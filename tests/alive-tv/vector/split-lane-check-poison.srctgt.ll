@@ -0,0 +1,14 @@
+; TEST-ARGS: -split-lane-check
+; ERROR: Target is more poisonous than source
+
+define { i8, i32 } @src(i8 %a, i32 %b) {
+  %s = insertvalue { i8, i32 } undef, i8 %a, 0
+  %t = insertvalue { i8, i32 } %s, i32 %b, 1
+  ret { i8, i32 } %t
+}
+
+define { i8, i32 } @tgt(i8 %a, i32 %b) {
+  %s = insertvalue { i8, i32 } undef, i8 %a, 0
+  %t = insertvalue { i8, i32 } %s, i32 poison, 1
+  ret { i8, i32 } %t
+}
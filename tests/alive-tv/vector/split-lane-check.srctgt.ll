@@ -0,0 +1,13 @@
+; TEST-ARGS: -split-lane-check
+
+define <4 x i8> @src(<4 x i8> %x, i8 %a) {
+  %v = insertelement <4 x i8> %x, i8 %a, i32 1
+  %w = add <4 x i8> %v, %v
+  ret <4 x i8> %w
+}
+
+define <4 x i8> @tgt(<4 x i8> %x, i8 %a) {
+  %v = insertelement <4 x i8> %x, i8 %a, i32 1
+  %w = shl <4 x i8> %v, <i8 1, i8 1, i8 1, i8 1>
+  ret <4 x i8> %w
+}
@@ -3,6 +3,7 @@
 
 #include "cache/cache.h"
 #include "ir/type.h"
+#include "llvm_util/known_fns.h"
 #include "llvm_util/llvm2alive.h"
 #include "smt/expr.h"
 #include "smt/smt.h"
@@ -273,5 +274,8 @@ will attempt to execute every function in the bitcode file.
   if (opt_alias_stats)
     IR::Memory::printAliasStats(cout);
 
+  if (opt_known_fns_stats)
+    llvm_util::known_fns_print_stats(cout);
+
   return errorCount > 0;
 }
@@ -0,0 +1,486 @@
+// Copyright (c) 2018-present The Alive2 Authors.
+// Distributed under the MIT license that can be found in the LICENSE file.
+
+// Aggregates the reports produced by alive-tv/the tv plugin.
+// Files are mmap'ed and scanned line by line by a pool of threads, so memory
+// usage doesn't depend on the size of the logs.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+namespace {
+
+// position of the first occurrence of a key: (file index, offset)
+// used to break ties in the same way as a stable sort in insertion order
+using Pos = pair<unsigned, size_t>;
+
+struct Counter {
+  unsigned long long count = 0;
+  Pos first = { ~0u, 0 };
+};
+
+class Histogram {
+  unordered_map<string, Counter> map;
+
+public:
+  void add(string_view key, const Pos &pos, unsigned long long n = 1) {
+    auto &c = map[string(key)];
+    c.count += n;
+    c.first  = min(c.first, pos);
+  }
+
+  void merge(const Histogram &other) {
+    for (auto &[key, c] : other.map) {
+      add(key, c.first, c.count);
+    }
+  }
+
+  unsigned long long total() const {
+    unsigned long long n = 0;
+    for (auto &[key, c] : map) {
+      n += c.count;
+    }
+    return n;
+  }
+
+  // sorted by decreasing count (if by_count) and then by first occurrence
+  vector<pair<const string*, unsigned long long>>
+  sorted(bool by_count = true) const {
+    vector<pair<const string*, const Counter*>> v;
+    for (auto &[key, c] : map) {
+      v.emplace_back(&key, &c);
+    }
+    sort(v.begin(), v.end(), [=](auto &a, auto &b) {
+      if (by_count && a.second->count != b.second->count)
+        return a.second->count > b.second->count;
+      return a.second->first < b.second->first;
+    });
+    vector<pair<const string*, unsigned long long>> ret;
+    for (auto &[key, c] : v) {
+      ret.emplace_back(key, c->count);
+    }
+    return ret;
+  }
+};
+
+struct Stats {
+  unsigned long long correct = 0;
+  Histogram errors, unsupported, knownfns, smt;
+
+  void merge(const Stats &other) {
+    correct += other.correct;
+    errors.merge(other.errors);
+    unsupported.merge(other.unsupported);
+    knownfns.merge(other.knownfns);
+    smt.merge(other.smt);
+  }
+};
+
+class MappedFile {
+  void *ptr = MAP_FAILED;
+  size_t sz = 0;
+
+public:
+  MappedFile(const fs::path &path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1)
+      return;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) {
+      sz = st.st_size;
+      ptr = mmap(nullptr, sz, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (ptr != MAP_FAILED)
+        madvise(ptr, sz, MADV_SEQUENTIAL);
+    }
+    close(fd);
+  }
+
+  ~MappedFile() {
+    if (ptr != MAP_FAILED)
+      munmap(ptr, sz);
+  }
+
+  string_view operator*() const {
+    if (ptr == MAP_FAILED)
+      return {};
+    return { (const char*)ptr, sz };
+  }
+};
+
+string_view trim(string_view s) {
+  const char *ws = " \t\n\r\v";
+  auto b = s.find_first_not_of(ws, 0, 5);
+  if (b == string_view::npos)
+    return {};
+  auto e = s.find_last_not_of(ws, string_view::npos, 5);
+  return s.substr(b, e - b + 1);
+}
+
+bool is_space(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' ||
+         c == '\f';
+}
+
+// %\S+ = ([^%[(]+)
+bool match_instr(string_view str, string_view &out) {
+  for (size_t i = 0; (i = str.find('%', i)) != string_view::npos; ++i) {
+    size_t j = i + 1;
+    while (j < str.size() && !is_space(str[j]))
+      ++j;
+    if (j == i + 1 || str.substr(j, 3) != " = ")
+      continue;
+    j += 3;
+    auto len = str.substr(j).find_first_of("%[(");
+    if (len == 0)
+      continue;
+    out = str.substr(j, len);
+    return true;
+  }
+  return false;
+}
+
+// Scans a text report, matching the same patterns as scripts/stats.php did
+class ReportScanner {
+  Stats &stats;
+  unsigned file;
+  string_view txt;
+  size_t pos = 0;
+  size_t unsupported_end = 0; // end of the last "Unsupported <kind>:" match
+
+  string_view nextLine() {
+    auto end = txt.find('\n', pos);
+    if (end == string_view::npos)
+      end = txt.size();
+    auto line = txt.substr(pos, end - pos);
+    pos = end + 1;
+    return line;
+  }
+
+  // \s*(.+): may continue over blank lines
+  string_view restOfMatch(string_view rest) {
+    auto str = trim(rest);
+    if (!str.empty())
+      return rest.substr(rest.find(str[0]));
+
+    auto next = txt.find_first_not_of(" \t\n\r\v\f", pos);
+    if (next == string_view::npos)
+      return {};
+    return txt.substr(next, txt.find('\n', next) - next);
+  }
+
+  void scanLine(string_view line, size_t offset) {
+    Pos p(file, offset);
+    for (size_t i = 0;
+         (i = line.find("Transformation seems to be correct!", i)) !=
+           string_view::npos;
+         ++i) {
+      ++stats.correct;
+    }
+
+    if (auto i = line.find("ERROR: "); i != string_view::npos) {
+      auto err = line.substr(i + 7);
+      if (!err.empty() && err.find("Unsupported ") == string_view::npos)
+        stats.errors.add(err, p);
+    }
+
+    // Num ([a-zA-Z]+): +(\d+)
+    for (size_t i = 0; (i = line.find("Num ", i)) != string_view::npos; ++i) {
+      size_t j = i + 4, k = j;
+      while (k < line.size() && isalpha((unsigned char)line[k]))
+        ++k;
+      if (k == j || k + 1 >= line.size() || line[k] != ':' || line[k+1] != ' ')
+        continue;
+      size_t l = k + 1;
+      while (l < line.size() && line[l] == ' ')
+        ++l;
+      if (l < line.size() && isdigit((unsigned char)line[l]))
+        stats.smt.add(line.substr(j, k - j), p,
+                      strtoull(line.data() + l, nullptr, 10));
+    }
+
+    for (size_t i = 0;
+         (i = line.find("Unsupported ", i)) != string_view::npos; ++i) {
+      auto rest = line.substr(i + 12);
+
+      // Unsupported (?:instruction|type|attribute|constant):\s*(.+)
+      // The match spans the rest of the line (or the next non-blank one),
+      // so further occurrences within it don't count
+      if (offset + i >= unsupported_end) {
+        for (string_view kind : { "instruction:", "type:", "attribute:",
+                                  "constant:" }) {
+          if (!rest.starts_with(kind))
+            continue;
+          auto str = restOfMatch(rest.substr(kind.size()));
+          if (str.empty())
+            break;
+          string_view instr;
+          stats.unsupported.add(trim(match_instr(str, instr) ? instr : str),
+                                p);
+          unsupported_end = str.data() + str.size() - txt.data();
+          break;
+        }
+      }
+
+      // Unsupported metadata:\s*(\d+)
+      if (rest.starts_with("metadata:")) {
+        auto str = restOfMatch(rest.substr(9));
+        size_t n = 0;
+        while (n < str.size() && isdigit((unsigned char)str[n]))
+          ++n;
+        if (n > 0)
+          stats.unsupported.add("metadata " + string(str.substr(0, n)), p);
+      }
+    }
+
+    if (auto i = line.find(" - Unknown libcall: @");
+        i != string_view::npos) {
+      stats.knownfns.add(line.substr(i + 20), p);
+    }
+  }
+
+public:
+  ReportScanner(Stats &stats, unsigned file, string_view txt)
+    : stats(stats), file(file), txt(txt) {}
+
+  void run() {
+    while (pos < txt.size()) {
+      auto offset = pos;
+      scanLine(nextLine(), offset);
+    }
+  }
+};
+
+// Returns the index of the closing quote of the string starting at i
+size_t json_skip_string(string_view obj, size_t i) {
+  for (++i; i < obj.size() && obj[i] != '"'; ++i) {
+    if (obj[i] == '\\')
+      ++i;
+  }
+  return i;
+}
+
+// Returns the index of the value of "key" in the top level of a JSON object
+// produced by ResultStream, or npos. Keys of nested objects and contents of
+// strings (e.g., the report) don't match.
+size_t json_find(string_view obj, string_view key) {
+  unsigned depth = 0;
+  for (size_t i = 0; i < obj.size(); ++i) {
+    switch (obj[i]) {
+    case '{':
+    case '[':
+      ++depth;
+      break;
+    case '}':
+    case ']':
+      --depth;
+      break;
+    case '"': {
+      auto start = i + 1;
+      i = json_skip_string(obj, i);
+      if (depth == 1 && i + 1 < obj.size() && obj[i + 1] == ':' &&
+          obj.substr(start, i - start) == key)
+        return i + 2;
+      break;
+    }
+    }
+  }
+  return string_view::npos;
+}
+
+// Returns the nested object "key" of a JSON object, or an empty view
+string_view json_object(string_view obj, string_view key) {
+  auto i = json_find(obj, key);
+  if (i == string_view::npos || i >= obj.size() || obj[i] != '{')
+    return {};
+
+  unsigned depth = 0;
+  for (auto j = i; j < obj.size(); ++j) {
+    if (obj[j] == '"')
+      j = json_skip_string(obj, j);
+    else if (obj[j] == '{')
+      ++depth;
+    else if (obj[j] == '}' && --depth == 0)
+      return obj.substr(i, j - i + 1);
+  }
+  return {};
+}
+
+// Returns the value of "key" in a JSON object produced by ResultStream.
+// Strings are unescaped; numbers are returned verbatim.
+bool json_field(string_view obj, string_view key, string &out) {
+  auto i = json_find(obj, key);
+  if (i == string_view::npos)
+    return false;
+  out.clear();
+
+  if (i < obj.size() && obj[i] == '"') {
+    for (++i; i < obj.size() && obj[i] != '"'; ++i) {
+      if (obj[i] != '\\') {
+        out += obj[i];
+        continue;
+      }
+      if (++i == obj.size())
+        break;
+      switch (obj[i]) {
+      case 'n': out += '\n'; break;
+      case 't': out += '\t'; break;
+      case 'u':
+        out += (char)strtoul(string(obj.substr(i + 1, 4)).c_str(), nullptr,
+                             16);
+        i += 4;
+        break;
+      default: out += obj[i]; break;
+      }
+    }
+    return true;
+  }
+
+  while (i < obj.size() && (isdigit((unsigned char)obj[i]) || obj[i] == '.'))
+    out += obj[i++];
+  return !out.empty();
+}
+
+// Scans a JSON Lines file written with -result-stream
+void scan_result_stream(Stats &stats, unsigned file, string_view txt) {
+  // field name in the stream -> name printed by solver_print_stats
+  static const pair<const char*, const char*> smt_fields[] = {
+    { "queries", "queries" }, { "invalid", "invalid" }, { "skips", "skips" },
+    { "trivial", "trivial" }, { "timeout", "timeout" }, { "errors", "errors" },
+    { "sat", "SAT" }, { "unsat", "UNSAT" },
+  };
+
+  string status, value;
+  for (size_t pos = 0; pos < txt.size(); ) {
+    auto end = txt.find('\n', pos);
+    if (end == string_view::npos)
+      end = txt.size();
+    auto line = txt.substr(pos, end - pos);
+    Pos p(file, pos);
+    pos = end + 1;
+
+    if (!json_field(line, "status", status))
+      continue;
+
+    if (status == "correct" || status == "syntactically-equal")
+      ++stats.correct;
+    else if (status == "type-error")
+      stats.errors.add("program doesn't type check!", p);
+    else if (status != "skipped")
+      stats.errors.add(json_field(line, "error", value) ? value : status, p);
+
+    if (auto obj = json_object(line, "smt"); !obj.empty()) {
+      for (auto [field, name] : smt_fields) {
+        if (json_field(obj, field, value))
+          stats.smt.add(name, p, strtoull(value.c_str(), nullptr, 10));
+      }
+    }
+  }
+}
+
+void print_top(const Histogram &h, unsigned limit = 0) {
+  unsigned i = 0;
+  for (auto &[key, count] : h.sorted()) {
+    cout << count << '\t' << *key << '\n';
+    if (++i == limit)
+      break;
+  }
+}
+
+}
+
+
+int main(int argc, char **argv) {
+  if (argc != 2 || !fs::exists(argv[1])) {
+    cerr << "Use: " << argv[0] << " <log dir | result stream file>\n";
+    return -1;
+  }
+
+  vector<fs::path> files;
+  bool is_stream = !fs::is_directory(argv[1]);
+  if (is_stream) {
+    files.emplace_back(argv[1]);
+  } else {
+    for (auto &entry : fs::directory_iterator(argv[1])) {
+      if (entry.path().extension() == ".txt")
+        files.emplace_back(entry.path());
+    }
+    sort(files.begin(), files.end());
+  }
+
+  unsigned num_threads
+    = max(1u, min(thread::hardware_concurrency(), (unsigned)files.size()));
+  vector<Stats> thread_stats(num_threads);
+  atomic<unsigned> next_file = 0;
+
+  auto worker = [&](Stats &stats) {
+    unsigned i;
+    while ((i = next_file++) < files.size()) {
+      MappedFile file(files[i]);
+      if (is_stream)
+        scan_result_stream(stats, i, *file);
+      else
+        ReportScanner(stats, i, *file).run();
+    }
+  };
+
+  vector<thread> threads;
+  for (unsigned i = 1; i < num_threads; ++i) {
+    threads.emplace_back(worker, ref(thread_stats[i]));
+  }
+  worker(thread_stats[0]);
+  for (auto &t : threads) {
+    t.join();
+  }
+
+  Stats stats;
+  for (auto &s : thread_stats) {
+    stats.merge(s);
+  }
+
+  auto num_errors = stats.errors.total() + stats.unsupported.total() +
+                    stats.knownfns.total();
+  auto total = stats.correct + num_errors;
+  char pc[16];
+  snprintf(pc, sizeof(pc), "%.2f", total ? num_errors * 100.0 / total : 0.0);
+
+  cout << "Total correct: " << stats.correct << '\n'
+       << "Total vcgen failures: " << num_errors << " (" << pc << "%)\n\n";
+
+  cout << "SMT Statistics:\n";
+  for (auto &[key, count] : stats.smt.sorted(/*by_count=*/false)) {
+    if (count > 0) {
+      string name = *key + ':';
+      name.resize(max(name.size(), (size_t)10), ' ');
+      cout << name << count << '\n';
+    }
+  }
+
+  cout << "\nErrors:\n";
+  print_top(stats.errors);
+
+  cout << "\nUnsupported IR features (Top 20):\n";
+  print_top(stats.unsupported, 20);
+
+  cout << "\nUnsupported known functions (Top 20):\n";
+  print_top(stats.knownfns, 20);
+
+  return 0;
+}
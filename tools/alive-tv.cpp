@@ -2,10 +2,12 @@
 // Distributed under the MIT license that can be found in the LICENSE file.
 
 #include "cache/cache.h"
+#include "llvm_util/known_fns.h"
 #include "llvm_util/llvm2alive.h"
 #include "llvm_util/llvm_optimizer.h"
 #include "smt/smt.h"
 #include "tools/transform.h"
+#include "util/stopwatch.h"
 #include "util/version.h"
 
 #include "llvm/ADT/StringExtras.h"
@@ -27,6 +29,7 @@
 
 #include <fstream>
 #include <iostream>
+#include <optional>
 #include <sstream>
 #include <utility>
 
@@ -91,7 +94,8 @@ optional<smt::smt_initializer> smt_init;
 unique_ptr<Cache> cache;
 
 struct Results {
-  Transform t;
+  // heap allocated as the errors may reference it until they are printed
+  unique_ptr<Transform> t = make_unique<Transform>();
   string error;
   Errors errs;
   enum {
@@ -111,42 +115,87 @@ struct Results {
   }
 };
 
+// A pair of functions translated ahead of verification
+struct Translation {
+  optional<IR::Function> src, tgt;
+  string output; // printed by the translation
+};
+
+vector<Translation>
+translate(const vector<pair<llvm::Function*, llvm::Function*>> &fns,
+          const llvm::Triple &triple) {
+  ScopedStage stage("translation");
+  llvm::TargetLibraryInfoImpl TLIImpl(triple);
+  vector<Translation> ret(fns.size());
+  auto outputs = llvm2alive_parallel(fns.size(), opt_translation_threads,
+                                     [&](unsigned i) {
+    auto &[F1, F2] = fns[i];
+    auto &t = ret[i];
+    t.src = llvm2alive(*F1, llvm::TargetLibraryInfo(TLIImpl, F1), true);
+    if (t.src)
+      t.tgt = llvm2alive(*F2, llvm::TargetLibraryInfo(TLIImpl, F2), false,
+                         t.src->getGlobalVarNames());
+  });
+  for (unsigned i = 0, e = ret.size(); i != e; ++i) {
+    ret[i].output = std::move(outputs[i]);
+  }
+  return ret;
+}
+
 Results verify(llvm::Function &F1, llvm::Function &F2,
                llvm::TargetLibraryInfoWrapperPass &TLI,
+               VerificationRecord &rec,
                bool print_transform = false,
-               bool always_verify = false) {
-  auto fn1 = llvm2alive(F1, TLI.getTLI(F1), true);
+               bool always_verify = false,
+               Translation *translated = nullptr) {
+  optional<ScopedWatch> watch(rec.stage("translation"));
+  optional<ScopedStage> stage(in_place, "translation");
+  optional<IR::Function> fn1, fn2;
+  if (translated) {
+    *out << translated->output;
+    fn1 = std::move(translated->src);
+    fn2 = std::move(translated->tgt);
+  } else {
+    fn1 = llvm2alive(F1, TLI.getTLI(F1), true);
+  }
   if (!fn1)
     return Results::Error("Could not translate '" + F1.getName().str() +
                           "' to Alive IR\n");
 
-  auto fn2 = llvm2alive(F2, TLI.getTLI(F2), false, fn1->getGlobalVarNames());
+  if (!translated)
+    fn2 = llvm2alive(F2, TLI.getTLI(F2), false, fn1->getGlobalVarNames());
   if (!fn2)
     return Results::Error("Could not translate '" + F2.getName().str() +
                           "' to Alive IR\n");
 
+  stage.reset();
+
   Results r;
-  r.t.src = std::move(*fn1);
-  r.t.tgt = std::move(*fn2);
+  r.t->src = std::move(*fn1);
+  r.t->tgt = std::move(*fn2);
 
   if (!always_verify) {
     stringstream ss1, ss2;
-    r.t.src.print(ss1);
-    r.t.tgt.print(ss2);
-    if (std::move(ss1).str() == std::move(ss2).str()) {
+    r.t->src.print(ss1);
+    r.t->tgt.print(ss2);
+    auto src_str = std::move(ss1).str(), tgt_str = std::move(ss2).str();
+    if (src_str == tgt_str || r.t->isAlphaEquivalent(src_str, tgt_str)) {
       if (print_transform)
-        r.t.print(*out, {});
+        r.t->print(*out, {});
       r.status = Results::SYNTACTIC_EQ;
       return r;
     }
   }
 
   smt_init->reset();
-  r.t.preprocess();
-  TransformVerify verifier(r.t, false);
+  watch.emplace(rec.stage("preprocess"));
+  r.t->preprocess();
+  watch.reset();
+  TransformVerify verifier(*r.t, false);
+  verifier.setRecord(&rec);
 
   if (print_transform)
-    r.t.print(*out, {});
+    r.t->print(*out, {});
 
   {
     auto types = verifier.getTypings();
@@ -172,17 +221,27 @@ unsigned num_failed = 0;
 unsigned num_errors = 0;
 
 bool compareFunctions(llvm::Function &F1, llvm::Function &F2,
-                      llvm::TargetLibraryInfoWrapperPass &TLI) {
-  auto r = verify(F1, F2, TLI, !opt_quiet, opt_always_verify);
+                      llvm::TargetLibraryInfoWrapperPass &TLI,
+                      Translation *translated = nullptr) {
+  VerificationRecord rec;
+  rec.function = F1.getName().str();
+  rec.report   = report_filename.string();
+  ScopedStage stage(rec.function);
+
+  auto r = verify(F1, F2, TLI, rec, !opt_quiet, opt_always_verify,
+                  translated);
   if (r.status == Results::ERROR) {
     *out << "ERROR: " << r.error;
     ++num_errors;
+    rec.status = VerificationRecord::Error;
+    rec.error_class = r.error.substr(0, r.error.find('\n'));
+    result_stream.write(rec);
     return true;
   }
 
   if (opt_print_dot) {
-    r.t.src.writeDot("src");
-    r.t.tgt.writeDot("tgt");
+    r.t->src.writeDot("src");
+    r.t->tgt.writeDot("tgt");
   }
 
   switch (r.status) {
@@ -193,17 +252,23 @@ bool compareFunctions(llvm::Function &F1, llvm::Function &F2,
   case Results::SYNTACTIC_EQ:
     *out << "Transformation seems to be correct! (syntactically equal)\n\n";
     ++num_correct;
+    rec.status = VerificationRecord::SyntacticEq;
+    result_stream.write(rec);
     break;
 
   case Results::CORRECT:
     *out << "Transformation seems to be correct!\n\n";
     ++num_correct;
+    rec.status = VerificationRecord::Correct;
+    result_stream.write(rec);
     break;
 
   case Results::TYPE_CHECKER_FAILED:
     *out << "Transformation doesn't verify!\n"
             "ERROR: program doesn't type check!\n\n";
     ++num_errors;
+    rec.status = VerificationRecord::TypeCheckFailed;
+    result_stream.write(rec);
     return true;
 
   case Results::UNSOUND:
@@ -211,16 +276,25 @@ bool compareFunctions(llvm::Function &F1, llvm::Function &F2,
     if (!opt_quiet)
       *out << r.errs << endl;
     ++num_unsound;
+    rec.setErrors(r.errs);
+    result_stream.write(rec);
     return false;
 
   case Results::FAILED_TO_PROVE:
     *out << r.errs << endl;
     ++num_failed;
+    rec.setErrors(r.errs);
+    result_stream.write(rec);
     return true;
   }
 
   if (opt_bidirectional) {
-    r = verify(F2, F1, TLI, false, opt_always_verify);
+    // reported as a separate record, told apart by the pass name
+    VerificationRecord rec_rev;
+    rec_rev.function = rec.function;
+    rec_rev.pass     = "reverse";
+    rec_rev.report   = rec.report;
+    r = verify(F2, F1, TLI, rec_rev, false, opt_always_verify);
     switch (r.status) {
     case Results::ERROR:
     case Results::TYPE_CHECKER_FAILED:
@@ -230,18 +304,26 @@ bool compareFunctions(llvm::Function &F1, llvm::Function &F2,
     case Results::SYNTACTIC_EQ:
     case Results::CORRECT:
       *out << "These functions seem to be equivalent!\n\n";
+      rec_rev.status = r.status == Results::CORRECT
+                         ? VerificationRecord::Correct
+                         : VerificationRecord::SyntacticEq;
+      result_stream.write(rec_rev);
       return true;
 
     case Results::FAILED_TO_PROVE:
       *out << "Failed to verify the reverse transformation\n\n";
       if (!opt_quiet)
         *out << r.errs << endl;
+      rec_rev.setErrors(r.errs);
+      result_stream.write(rec_rev);
       return true;
 
     case Results::UNSOUND:
       *out << "Reverse transformation doesn't verify!\n\n";
       if (!opt_quiet)
         *out << r.errs << endl;
+      rec_rev.setErrors(r.errs);
+      result_stream.write(rec_rev);
       return false;
     }
   }
@@ -342,29 +424,43 @@ convenient way to demonstrate an existing optimizer bug.
     return -1;
   }
 
-  // FIXME: quadratic, may not be suitable for very large modules
-  // emitted by opt-fuzz
-  for (auto &F1 : *M1.get()) {
-    if (F1.isDeclaration())
-      continue;
-    if (F1.getName().empty())
-      M1_anon_count++;
-    if (!func_names.empty() && !func_names.count(F1.getName().str()))
-      continue;
-    unsigned M2_anon_count = 0;
-    for (auto &F2 : *M2.get()) {
-      if (F2.isDeclaration())
+  {
+    // FIXME: quadratic, may not be suitable for very large modules
+    // emitted by opt-fuzz
+    vector<pair<llvm::Function*, llvm::Function*>> fns;
+    for (auto &F1 : *M1.get()) {
+      if (F1.isDeclaration())
         continue;
-      if (F2.getName().empty())
-        M2_anon_count++;
-      if ((F1.getName().empty() && (M1_anon_count == M2_anon_count)) ||
-          (F1.getName() == F2.getName())) {
-        if (!compareFunctions(F1, F2, TLI))
-          if (opt_error_fatal)
-            goto end;
-        break;
+      if (F1.getName().empty())
+        M1_anon_count++;
+      if (!func_names.empty() && !func_names.count(F1.getName().str()))
+        continue;
+      unsigned M2_anon_count = 0;
+      for (auto &F2 : *M2.get()) {
+        if (F2.isDeclaration())
+          continue;
+        if (F2.getName().empty())
+          M2_anon_count++;
+        // anonymous functions are matched by position
+        if (F1.getName().empty()
+              ? F2.getName().empty() && M1_anon_count == M2_anon_count
+              : F1.getName() == F2.getName()) {
+          fns.emplace_back(&F1, &F2);
+          break;
+        }
       }
     }
+
+    vector<Translation> translated;
+    if (opt_translation_threads > 1)
+      translated = translate(fns, targetTriple);
+
+    for (unsigned i = 0, e = fns.size(); i != e; ++i) {
+      if (!compareFunctions(*fns[i].first, *fns[i].second, TLI,
+                            translated.empty() ? nullptr : &translated[i]))
+        if (opt_error_fatal)
+          goto end;
+    }
   }
 
   *out << "Summary:\n"
@@ -374,13 +470,19 @@ convenient way to demonstrate an existing optimizer bug.
           "  " << num_errors << " Alive2 errors\n";
 
 end:
-  if (opt_smt_stats)
+  stage_times_flush();
+  if (opt_smt_stats) {
     smt::solver_print_stats(*out);
+    transform_print_stats(*out);
+  }
 
   smt_init.reset();
 
   if (opt_alias_stats)
     IR::Memory::printAliasStats(*out);
 
+  if (opt_known_fns_stats)
+    llvm_util::known_fns_print_stats(*out);
+
   return num_errors > 0;
 }
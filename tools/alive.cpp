@@ -6,6 +6,7 @@
 #include "tools/alive_parser.h"
 #include "util/config.h"
 #include "util/file.h"
+#include "util/stopwatch.h"
 #include "util/version.h"
 #include <cstdlib>
 #include <iostream>
@@ -33,9 +34,17 @@ static void show_help() {
           " -smt-verbose\t\tPrint all SMT queries\n"
           " -tactic-verbose\tDebug SMT tactics\n"
           " -smt-log\t\tLog interactions with the SMT solver\n"
+          " -result-stream:file\tAppend a JSON record per transform to file\n"
+          " -time-stages:file\tAppend the time of each stage to file "
+          "(flamegraph format)\n"
+          " -trace:file\t\tAppend a timeline of the stages to file "
+          "(Chrome trace format)\n"
           " -skip-smt\t\tSkip all SMT queries\n"
           " -disable-poison-input\tAssume input variables can never be poison\n"
           " -disable-undef-input\tAssume input variables can never be undef\n"
+          " -split-memory-check\tCheck memory refinement one block at a time\n"
+          " -split-lane-check\tCheck vector/aggregate refinement one element at "
+          "a time\n"
           " -h / --help / -v / --version\tShow this help\n";
 }
 
@@ -44,6 +53,7 @@ int main(int argc, char **argv) {
   bool verbose = false;
   bool show_smt_stats = false;
   bool root_only = false;
+  ResultStream result_stream;
 
   int argc_i = 1;
   for (; argc_i < argc; ++argc_i) {
@@ -70,12 +80,30 @@ int main(int argc, char **argv) {
       smt::solver_tactic_verbose(true);
     else if (arg == "-smt-log")
       smt::start_logging();
+    else if (arg.compare(0, 15, "-result-stream:") == 0 && arg.size() > 15) {
+      if (!result_stream.open(arg.substr(15).data())) {
+        cerr << "Couldn't open result stream file\n";
+        return -1;
+      }
+    }
+    else if (arg.compare(0, 13, "-time-stages:") == 0 && arg.size() > 13)
+      stage_times_enable(arg.substr(13).data());
+    else if (arg.compare(0, 7, "-trace:") == 0 && arg.size() > 7) {
+      if (!trace_enable(arg.substr(7).data())) {
+        cerr << "Couldn't open trace file\n";
+        return -1;
+      }
+    }
     else if (arg == "-skip-smt")
       config::skip_smt = true;
     else if (arg == "-disable-undef-input")
       config::disable_undef_input = true;
     else if (arg == "-disable-poison-input")
       config::disable_poison_input = true;
+    else if (arg == "-split-memory-check")
+      config::split_memory_check = true;
+    else if (arg == "-split-lane-check")
+      config::split_lane_check = true;
     else if (arg == "-h" || arg == "--help" || arg == "-v" ||
              arg == "--version") {
       show_help();
@@ -116,10 +144,17 @@ int main(int argc, char **argv) {
         t.print(cout, print_opts);
         cout << '\n';
 
+        VerificationRecord rec;
+        rec.function = t.name;
+        ScopedStage stage(t.name);
+
         TransformVerify tv(t, !root_only);
+        tv.setRecord(&rec);
         auto types = tv.getTypings();
         if (!types) {
           cerr << "Doesn't type check!\n";
+          rec.status = VerificationRecord::TypeCheckFailed;
+          result_stream.write(rec);
           continue;
         }
 
@@ -129,14 +164,18 @@ int main(int argc, char **argv) {
           tv.fixupTypes(types);
           if (auto errs = tv.verify()) {
             cerr << errs;
+            rec.setErrors(errs);
             correct = false;
             break;
           }
           cout << "\rDone: " << ++i << flush;
         }
         cout << '\n';
-        if (correct)
+        if (correct) {
           cout << "Transformation seems to be correct!\n";
+          rec.status = VerificationRecord::Correct;
+        }
+        result_stream.write(rec);
       }
     } catch (const FileIOException &e) {
       cerr << "Couldn't read the file" << endl;
@@ -147,8 +186,12 @@ int main(int argc, char **argv) {
     }
   }
 
-  if (show_smt_stats)
+  stage_times_flush();
+
+  if (show_smt_stats) {
     smt::solver_print_stats(cout);
+    transform_print_stats(cout);
+  }
 
   return 0;
 }
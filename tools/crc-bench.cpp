@@ -0,0 +1,63 @@
+// Copyright (c) 2018-present The Alive2 Authors.
+// Distributed under the MIT license that can be found in the LICENSE file.
+
+// Microbenchmark for the hashes in util/crc.h
+
+#include "util/crc.h"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+
+using namespace std;
+
+template <typename Fn>
+static void bench(const char *name, const string &data, unsigned iters,
+                  Fn &&fn) {
+  auto start = chrono::steady_clock::now();
+  uint64_t sink = 0;
+  for (unsigned i = 0; i < iters; ++i) {
+    sink += fn();
+  }
+  chrono::duration<double> secs = chrono::steady_clock::now() - start;
+  double mb = (double)data.size() * iters / (1024 * 1024);
+  cout << left << setw(24) << name << right << fixed << setprecision(1)
+       << setw(10) << mb / secs.count() << " MB/s  (" << hex << sink << dec
+       << ")\n";
+}
+
+int main(int argc, char **argv) {
+  size_t size = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1 << 20;
+  unsigned iters = argc > 2 ? strtoul(argv[2], nullptr, 10) : 256;
+
+  // printed functions are mostly ASCII text
+  string data(size, ' ');
+  mt19937 rng(0);
+  for (auto &c : data) {
+    c = 32 + rng() % 95;
+  }
+
+  cout << "Hashing " << size << " bytes " << iters << " times\n";
+
+  bench("crc64", data, iters, [&]() {
+    return crc_finalize(crc_update(crc_init(), data.data(), data.size()));
+  });
+
+  bench("crc128", data, iters, [&]() {
+    auto crc = crc128_update(crc128_init(), data.data(), data.size());
+    return crc128_finalize(crc).lo;
+  });
+
+  // streaming, in small chunks like operator<< when printing a function
+  bench("crc128 (crc_ostream)", data, iters, [&]() {
+    util::crc_ostream os;
+    for (size_t i = 0; i < data.size(); i += 16) {
+      os.write(data.data() + i, min((size_t)16, data.size() - i));
+    }
+    return os.hash().lo;
+  });
+
+  return 0;
+}
@@ -0,0 +1,203 @@
+// Copyright (c) 2018-present The Alive2 Authors.
+// Distributed under the MIT license that can be found in the LICENSE file.
+
+#include "tools/result_stream.h"
+#include "smt/smt.h"
+#include "util/compiler.h"
+#include "util/memusage.h"
+#include <algorithm>
+#include <cstdio>
+#include <fcntl.h>
+#include <string_view>
+#include <unistd.h>
+
+using namespace smt;
+using namespace tools;
+using namespace std;
+
+static constexpr size_t flush_threshold = 64 * 1024;
+
+static void escape(string &out, string_view str) {
+  out += '"';
+  for (char c : str) {
+    switch (c) {
+    case '"':  out += "\\\""; break;
+    case '\\': out += "\\\\"; break;
+    case '\n': out += "\\n"; break;
+    case '\t': out += "\\t"; break;
+    default:
+      if ((unsigned char)c < 0x20) {
+        char buf[8];
+        snprintf(buf, sizeof(buf), "\\u%04x", c);
+        out += buf;
+      } else {
+        out += c;
+      }
+    }
+  }
+  out += '"';
+}
+
+static const char* status_str(VerificationRecord::Status s) {
+  switch (s) {
+  case VerificationRecord::Correct:         return "correct";
+  case VerificationRecord::SyntacticEq:     return "syntactically-equal";
+  case VerificationRecord::Unsound:         return "unsound";
+  case VerificationRecord::FailedToProve:   return "failed-to-prove";
+  case VerificationRecord::TypeCheckFailed: return "type-error";
+  case VerificationRecord::Error:           return "error";
+  case VerificationRecord::Skipped:         return "skipped";
+  }
+  UNREACHABLE();
+}
+
+namespace tools {
+
+function<void(const util::StopWatch&)>
+VerificationRecord::stage(const char *name) {
+  return [this, name, rss = util::get_rss(), z3 = get_memory_usage()]
+         (const util::StopWatch &sw) {
+    auto rss_now = util::get_rss(), z3_now = get_memory_usage();
+    peak_rss = max(peak_rss, util::get_peak_rss());
+    peak_z3  = max(peak_z3, z3_now);
+
+    // stages may run more than once (e.g., once per typing); accumulate
+    auto I = find_if(stages.begin(), stages.end(),
+                     [&](auto &s) { return string_view(s.name) == name; });
+    auto &s = I != stages.end() ? *I : stages.emplace_back(name);
+    s.seconds += sw.seconds();
+    s.rss     += (int64_t)rss_now - (int64_t)rss;
+    s.z3      += (int64_t)z3_now - (int64_t)z3;
+  };
+}
+
+void VerificationRecord::setErrors(const util::Errors &errs) {
+  if (!errs) {
+    status = Correct;
+    return;
+  }
+  status = errs.isUnsound() ? Unsound : FailedToProve;
+
+  // the class is the first line of the message, without the variable name
+  // e.g., "Value mismatch for i8 %x" -> "Value mismatch"
+  auto &msg = errs.begin()->first;
+  auto cls = string_view(msg).substr(0, msg.find('\n'));
+  if (auto I = cls.find(" for "); I != string_view::npos)
+    cls = cls.substr(0, I);
+  error_class = cls;
+}
+
+
+ResultStream::~ResultStream() {
+  flush();
+  if (fd != -1)
+    close(fd);
+}
+
+bool ResultStream::open(const char *path) {
+  fd = ::open(path, O_WRONLY | O_CREAT | O_APPEND, 0644);
+  return fd != -1;
+}
+
+static void append_record(string &out, const VerificationRecord &r) {
+  auto smt = solver_get_stats() - r.smt_begin;
+  out += "{\"function\":";
+  escape(out, r.function);
+  out += ",\"pass\":";
+  escape(out, r.pass);
+  out += ",\"status\":\"";
+  out += status_str(r.status);
+  out += '"';
+  if (!r.error_class.empty()) {
+    out += ",\"error\":";
+    escape(out, r.error_class);
+  }
+
+  out += ",\"time\":{";
+  bool first = true;
+  for (auto &s : r.stages) {
+    if (!first)
+      out += ',';
+    first = false;
+    escape(out, s.name);
+    char buf[32];
+    snprintf(buf, sizeof(buf), ":%.6f", s.seconds);
+    out += buf;
+  }
+
+  out += "},\"mem\":{\"peak_rss\":" + to_string(r.peak_rss) +
+         ",\"peak_z3\":" + to_string(r.peak_z3) + ",\"stages\":{";
+  first = true;
+  for (auto &s : r.stages) {
+    if (!first)
+      out += ',';
+    first = false;
+    escape(out, s.name);
+    out += ":{\"rss\":" + to_string(s.rss) + ",\"z3\":" + to_string(s.z3) +
+           '}';
+  }
+
+  out += '}';
+  if (r.mem_pressure != MemoryPressure::None) {
+    out += ",\"pressure\":\"";
+    out += memory_pressure_str(r.mem_pressure);
+    out += '"';
+  }
+
+  out += "},\"smt\":{\"queries\":" + to_string(smt.queries) +
+         ",\"skips\":"    + to_string(smt.skips) +
+         ",\"invalid\":"  + to_string(smt.invalid) +
+         ",\"trivial\":"  + to_string(smt.trivial) +
+         ",\"sat\":"      + to_string(smt.sats) +
+         ",\"unsat\":"    + to_string(smt.unsats) +
+         ",\"timeout\":"  + to_string(smt.timeouts) +
+         ",\"errors\":"   + to_string(smt.errors) + '}';
+
+  if (!r.report.empty() && r.status != VerificationRecord::Correct &&
+      r.status != VerificationRecord::SyntacticEq) {
+    out += ",\"report\":";
+    escape(out, r.report);
+  }
+  out += "}\n";
+}
+
+string ResultStream::format(const VerificationRecord &r) {
+  string out;
+  append_record(out, r);
+  return out;
+}
+
+void ResultStream::write(const VerificationRecord &r) {
+  if (fd == -1)
+    return;
+
+  append_record(buffer, r);
+  if (buffer.size() >= flush_threshold)
+    flush();
+}
+
+void ResultStream::writeRaw(string_view data) const {
+  if (fd == -1)
+    return;
+
+  // O_APPEND makes each write land atomically at the end of the file
+  const char *ptr = data.data();
+  size_t size = data.size();
+  while (size > 0) {
+    auto n = ::write(fd, ptr, size);
+    if (n <= 0)
+      break;
+    ptr  += n;
+    size -= n;
+  }
+}
+
+void ResultStream::flush() {
+  if (fd == -1 || buffer.empty())
+    return;
+
+  writeRaw(buffer);
+  buffer.clear();
+}
+
+}
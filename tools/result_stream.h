@@ -0,0 +1,82 @@
+#pragma once
+
+// Copyright (c) 2018-present The Alive2 Authors.
+// Distributed under the MIT license that can be found in the LICENSE file.
+
+#include "smt/smt.h"
+#include "smt/solver.h"
+#include "util/errors.h"
+#include "util/stopwatch.h"
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace tools {
+
+// Machine-readable summary of the verification of one function pair.
+struct VerificationRecord {
+  enum Status {
+    Correct,
+    SyntacticEq,
+    Unsound,
+    FailedToProve,
+    TypeCheckFailed,
+    Error,
+    Skipped
+  };
+
+  std::string function;
+  std::string pass;
+  Status status = Error;
+  std::string error_class;
+
+  struct Stage {
+    const char *name;
+    float seconds = 0;
+    int64_t rss = 0; // change in resident memory, in bytes
+    int64_t z3 = 0;  // change in memory allocated by Z3, in bytes
+  };
+  std::vector<Stage> stages;
+  uint64_t peak_rss = 0, peak_z3 = 0;
+  // highest tier of memory pressure hit while verifying
+  smt::MemoryPressure mem_pressure = smt::MemoryPressure::None;
+
+  smt::SolverStats smt_begin = smt::solver_get_stats();
+  // where the full text report (with the counterexample) is written to
+  std::string report;
+
+  // Returns a ScopedWatch callback that accounts the time and memory used
+  // from now until the watch is destroyed.
+  std::function<void(const util::StopWatch&)> stage(const char *name);
+  void setErrors(const util::Errors &errs);
+};
+
+
+// Writes one JSON object per line. Records are buffered and written with a
+// single append so that concurrent writers (e.g., children of the parallel
+// tv plugin) never interleave partial records.
+class ResultStream {
+  int fd = -1;
+  std::string buffer;
+
+public:
+  ResultStream() = default;
+  ResultStream(const ResultStream&) = delete;
+  ~ResultStream();
+
+  bool open(const char *path);
+  bool isOpen() const { return fd != -1; }
+  void write(const VerificationRecord &r);
+  void flush();
+
+  // Returns the JSON line for r, for writing it later with writeRaw()
+  static std::string format(const VerificationRecord &r);
+  // Writes data to the file right away, bypassing the buffer.
+  // Only calls write(2), so it's safe to use from a signal handler.
+  void writeRaw(std::string_view data) const;
+};
+
+}
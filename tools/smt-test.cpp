@@ -0,0 +1,241 @@
+// Copyright (c) 2018-present The Alive2 Authors.
+// Distributed under the MIT license that can be found in the LICENSE file.
+
+// Unit tests for smt::expr's native (non-Z3) constants: each operation
+// folded over native constants must match what Z3's simplifier gives for the
+// same operation over Z3 constants, and constants that come out of Z3 must be
+// interchangeable with native ones.
+
+#include "smt/expr.h"
+#include "smt/smt.h"
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace smt;
+using namespace std;
+
+static unsigned num_checks = 0;
+static unsigned num_failures = 0;
+
+static void check(const char *op, const vector<expr> &args, const expr &got,
+                  const expr &expected) {
+  ++num_checks;
+  if (got.isValid() && got.eq(expected))
+    return;
+
+  ++num_failures;
+  cerr << "FAIL: " << op << '(';
+  for (auto &arg : args) {
+    cerr << (&arg == &args[0] ? "" : ", ") << arg;
+  }
+  cerr << ")\n  got:      " << got << "\n  expected: " << expected << '\n';
+}
+
+static void check(const char *what, bool cond) {
+  ++num_checks;
+  if (!cond) {
+    ++num_failures;
+    cerr << "FAIL: " << what << '\n';
+  }
+}
+
+using BinOp = function<expr(const expr&, const expr&)>;
+using UnOp = function<expr(const expr&)>;
+
+struct BinOpInfo {
+  const char *name;
+  BinOp op;
+  // expr's division operators return an arbitrary value when dividing by
+  // zero or on INT_MIN / -1 (both UB in LLVM; the callers guard them), so
+  // only the folding of Z3's operation is compared in those cases
+  bool div = false;
+};
+
+static const BinOpInfo bin_ops[] = {
+  { "add",  [](auto &a, auto &b) { return a + b; } },
+  { "sub",  [](auto &a, auto &b) { return a - b; } },
+  { "mul",  [](auto &a, auto &b) { return a * b; } },
+  { "udiv", [](auto &a, auto &b) { return a.udiv(b); }, true },
+  { "urem", [](auto &a, auto &b) { return a.urem(b); }, true },
+  { "sdiv", [](auto &a, auto &b) { return a.sdiv(b); }, true },
+  { "srem", [](auto &a, auto &b) { return a.srem(b); }, true },
+  { "shl",  [](auto &a, auto &b) { return a << b; } },
+  { "lshr", [](auto &a, auto &b) { return a.lshr(b); } },
+  { "ashr", [](auto &a, auto &b) { return a.ashr(b); } },
+  { "and",  [](auto &a, auto &b) { return a & b; } },
+  { "or",   [](auto &a, auto &b) { return a | b; } },
+  { "xor",  [](auto &a, auto &b) { return a ^ b; } },
+  { "eq",   [](auto &a, auto &b) { return a == b; } },
+  { "ule",  [](auto &a, auto &b) { return a.ule(b); } },
+  { "ult",  [](auto &a, auto &b) { return a.ult(b); } },
+  { "uge",  [](auto &a, auto &b) { return a.uge(b); } },
+  { "ugt",  [](auto &a, auto &b) { return a.ugt(b); } },
+  { "sle",  [](auto &a, auto &b) { return a.sle(b); } },
+  { "slt",  [](auto &a, auto &b) { return a.slt(b); } },
+  { "sge",  [](auto &a, auto &b) { return a.sge(b); } },
+  { "sgt",  [](auto &a, auto &b) { return a.sgt(b); } },
+  { "concat", [](auto &a, auto &b) { return a.concat(b); } },
+};
+
+static const pair<const char*, UnOp> un_ops[] = {
+  { "not",  [](auto &a) { return ~a; } },
+  { "neg",  [](auto &a) { return expr::mkUInt(0, a) - a; } },
+  { "zext", [](auto &a) { return a.zext(3); } },
+  { "sext", [](auto &a) { return a.sext(3); } },
+  { "extract_hi",
+    [](auto &a) { return a.extract(a.bits() - 1, a.bits() - 1); } },
+  { "extract_lo", [](auto &a) { return a.extract(a.bits() / 2, 0); } },
+};
+
+static const pair<const char*, BinOp> bool_ops[] = {
+  { "and",     [](auto &a, auto &b) { return a && b; } },
+  { "or",      [](auto &a, auto &b) { return a || b; } },
+  { "eq",      [](auto &a, auto &b) { return a == b; } },
+  { "ne",      [](auto &a, auto &b) { return a != b; } },
+  { "implies", [](auto &a, auto &b) { return a.implies(b); } },
+};
+
+// 0, 1 and -1 divisors, INT_MIN, INT_MAX, and shift amounts around bw
+static vector<expr> edge_values(unsigned bw) {
+  vector<uint64_t> vals = { 0, 1, 2, UINT64_MAX, bw - 1, bw, bw + 1,
+                            0x5a5a5a5a5a5a5a5aull };
+  vector<expr> ret;
+  for (auto v : vals) {
+    ret.emplace_back(expr::mkUInt(v, bw));
+  }
+  ret.emplace_back(expr::IntSMin(bw));
+  ret.emplace_back(expr::IntSMax(bw));
+  return ret;
+}
+
+static void test_bv(unsigned bw) {
+  expr x = expr::mkVar("x", bw);
+  expr y = expr::mkVar("y", bw);
+  auto vals = edge_values(bw);
+
+  for (auto &[name, op, div] : bin_ops) {
+    expr app = op(x, y);
+    for (auto &a : vals) {
+      for (auto &b : vals) {
+        expr z3 = app.subst({ { x, a }, { y, b } });
+        expr expected = z3.simplifyNoTimeout();
+        if (!div || (!b.isZero() && !(a.isSMin() && b.isAllOnes())))
+          check(name, { a, b }, op(a, b), expected);
+        check(name, { a, b }, z3.foldConst(), expected);
+      }
+    }
+  }
+
+  for (auto &[name, op] : un_ops) {
+    expr app = op(x);
+    for (auto &a : vals) {
+      expr z3 = app.subst(x, a);
+      expr expected = z3.simplifyNoTimeout();
+      check(name, { a }, op(a), expected);
+      check(name, { a }, z3.foldConst(), expected);
+    }
+  }
+}
+
+static void test_bool() {
+  expr x = expr::mkBoolVar("p");
+  expr y = expr::mkBoolVar("q");
+  expr vals[] = { false, true };
+
+  for (auto &[name, op] : bool_ops) {
+    expr app = op(x, y);
+    for (auto &a : vals) {
+      for (auto &b : vals) {
+        expr z3 = app.subst({ { x, a }, { y, b } });
+        expr expected = z3.simplifyNoTimeout();
+        check(name, { a, b }, op(a, b), expected);
+        check(name, { a, b }, z3.foldConst(), expected);
+      }
+    }
+  }
+
+  for (auto &a : vals) {
+    expr z3 = (!x).subst(x, a);
+    expr expected = z3.simplifyNoTimeout();
+    check("not", { a }, !a, expected);
+    check("not", { a }, z3.foldConst(), expected);
+  }
+}
+
+static unsigned num_native_lowered() {
+  ostringstream os;
+  expr_print_stats(os);
+  auto stats = std::move(os).str();
+  auto pos = stats.find(':', stats.find("Num native consts lowered"));
+  return stoul(stats.substr(pos + 1));
+}
+
+static void test_native_z3_mix() {
+  expr x = expr::mkVar("x", 8);
+  expr p = expr::mkBoolVar("p");
+  expr q = expr::mkBoolVar("q");
+  expr c = expr::mkUInt(42, 8);
+  expr wide = expr::mkUInt(42, 100);
+
+  // constants computed by Z3 and taken from Z3 applications
+  expr z3_c = (x + expr::mkUInt(1, 8)).subst(x, expr::mkUInt(41, 8))
+                .simplifyNoTimeout();
+  expr z3_true = (p && q).subst({ { p, true }, { q, true } })
+                   .simplifyNoTimeout();
+  expr app = x.concat(c), a, b;
+  check("isConcat(x, c)", app.isConcat(a, b) && a.eq(x));
+
+  check("eq(c, z3 c)", c.eq(z3_c) && z3_c.eq(c) && b.eq(c));
+  check("eq(true, z3 true)", expr(true).eq(z3_true) && z3_true.isTrue());
+  check("!eq(c, c:i16)", !c.eq(expr::mkUInt(42, 16)));
+  check("!eq(c, c:i100)", !c.eq(wide) && !wide.eq(c));
+  check("hash(c) == hash(z3 c)", c.hash() == z3_c.hash());
+
+  expr n, cond, then, els, e;
+  unsigned high, low;
+  check("isNot(!p)", (!p).isNot(n) && n.eq(p));
+  check("!isNot(true)", !expr(true).isNot(n) && !z3_true.isNot(n));
+  check("!isConcat(c)", !c.isConcat(a, b));
+  check("isExtract(x[3:0])",
+        x.extract(3, 0).isExtract(e, high, low) && e.eq(x) && high == 3 &&
+        low == 0);
+  check("!isExtract(c[3:0])", !c.extract(3, 0).isExtract(e, high, low));
+  check("isIf(p ? c : x)",
+        expr::mkIf(p, c, x).isIf(cond, then, els) && cond.eq(p) &&
+        then.eq(c) && els.eq(x));
+
+  // ordering and hashing must not lower native constants
+  unsigned lowered = num_native_lowered();
+  vector<expr> es = { c, z3_c, b, wide, x, app, expr(true), z3_true, p,
+                      expr::mkUInt(42, 16), expr::mkUInt(7, 8),
+                      expr::mkUInt(99, 8), expr::mkUInt(-1, 64) };
+  for (auto &l : es) {
+    for (auto &r : es) {
+      auto cmp = l <=> r;
+      check("<=> agrees with eq", (cmp == 0) == l.eq(r));
+      check("<=> is antisymmetric", (r <=> l) == (0 <=> cmp));
+    }
+    l.hash();
+    l.id();
+  }
+  check("set<expr>", set<expr>(es.begin(), es.end()).size() == 10);
+  check("<=>, hash and id don't lower", num_native_lowered() == lowered);
+}
+
+int main() {
+  smt_initializer smt_init;
+
+  for (unsigned bw : { 1, 8, 13, 32, 63, 64 }) {
+    test_bv(bw);
+  }
+  test_bool();
+  test_native_z3_mix();
+
+  cout << num_checks << " checks, " << num_failures << " failures\n";
+  return num_failures != 0;
+}
@@ -15,9 +15,11 @@
 #include <algorithm>
 #include <bit>
 #include <climits>
+#include <iomanip>
 #include <iostream>
 #include <map>
 #include <numeric>
+#include <optional>
 #include <set>
 #include <sstream>
 #include <unordered_map>
@@ -99,63 +101,10 @@ void tools::print_model_val(ostream &os, const State &st, const Model &m,
 
 using print_var_val_ty = function<void(ostream&, const Model&)>;
 
-static bool error(Errors &errs, const State &src_state, const State &tgt_state,
-                  const Result &r, const Value *var, const char *msg,
-                  bool check_each_var, print_var_val_ty print_var_val) {
-
-  if (r.isInvalid()) {
-    errs.add("Invalid expr", false);
-    return true;
-  }
-
-  if (r.isTimeout()) {
-    errs.add("Timeout", false);
-    return false;
-  }
-
-  if (r.isError()) {
-    errs.add("SMT Error: " + r.getReason(), false);
-    return false;
-  }
-
-  if (r.isSkip()) {
-    errs.add("Skip", false);
-    return true;
-  }
-
-  stringstream s;
-  string empty;
-  auto &var_name = var ? var->getName() : empty;
-  auto &m = r.getModel();
-
-  {
-    // filter out approximations that don't contribute to the bug
-    // i.e., they don't show up in the SMT model
-    set<string> approx;
-    for (auto *v : { &src_state.getApproximations(),
-                     &tgt_state.getApproximations() }) {
-      for (auto &[msg, var] : *v) {
-        if (!var || m.hasFnModel(*var))
-          approx.emplace(msg);
-      }
-    }
-
-    if (!approx.empty()) {
-      s << "Couldn't prove the correctness of the transformation\n"
-          "Alive2 approximated the semantics of the programs and therefore we\n"
-          "cannot conclude whether the bug found is valid or not.\n\n"
-          "Approximations done:\n";
-      for (auto &msg : approx) {
-        s << " - " << msg << '\n';
-      }
-      errs.add(s.str(), false);
-      return false;
-    }
-  }
-
-  s << msg;
-  if (!var_name.empty())
-    s << " for " << *var;
+static void print_counterexample(ostream &s, const State &src_state,
+                                 const State &tgt_state, const Model &m,
+                                 const string &var_name, bool check_each_var,
+                                 const print_var_val_ty &print_var_val) {
   s << "\n\nExample:\n";
 
   for (auto &[var, val] : src_state.getValues()) {
@@ -237,7 +186,79 @@ static bool error(Errors &errs, const State &src_state, const State &tgt_state,
   }
 
   print_var_val(s, m);
-  errs.add(s.str(), true);
+}
+
+// The counterexample is only rendered when the errors are printed, so the
+// model and the states are kept alive until then.
+static bool error(Errors &errs, const shared_ptr<State> &src_state_ptr,
+                  const shared_ptr<State> &tgt_state_ptr, Result &&r,
+                  const Value *var, const char *msg, bool check_each_var,
+                  print_var_val_ty print_var_val) {
+  auto &src_state = *src_state_ptr;
+  auto &tgt_state = *tgt_state_ptr;
+
+  if (r.isInvalid()) {
+    errs.add("Invalid expr", false);
+    return true;
+  }
+
+  if (r.isTimeout()) {
+    errs.add("Timeout", false);
+    return false;
+  }
+
+  if (r.isError()) {
+    errs.add("SMT Error: " + r.getReason(), false);
+    return false;
+  }
+
+  if (r.isSkip()) {
+    errs.add("Skip", false);
+    return true;
+  }
+
+  stringstream s;
+  string empty;
+  auto &var_name = var ? var->getName() : empty;
+  auto &m = r.getModel();
+
+  {
+    // filter out approximations that don't contribute to the bug
+    // i.e., they don't show up in the SMT model
+    set<string> approx;
+    for (auto *v : { &src_state.getApproximations(),
+                     &tgt_state.getApproximations() }) {
+      for (auto &[msg, var] : *v) {
+        if (!var || m.hasFnModel(*var))
+          approx.emplace(msg);
+      }
+    }
+
+    if (!approx.empty()) {
+      s << "Couldn't prove the correctness of the transformation\n"
+          "Alive2 approximated the semantics of the programs and therefore we\n"
+          "cannot conclude whether the bug found is valid or not.\n\n"
+          "Approximations done:\n";
+      for (auto &msg : approx) {
+        s << " - " << msg << '\n';
+      }
+      errs.add(s.str(), false);
+      return false;
+    }
+  }
+
+  s << msg;
+  if (!var_name.empty())
+    s << " for " << *var;
+
+  auto res = make_shared<Result>(std::move(r));
+  errs.add(std::move(s).str(), true,
+           [=, var_name = var_name, print_var_val = std::move(print_var_val)]
+           (ostream &os) {
+    ScopedStage stage("counterexample");
+    print_counterexample(os, *src_state_ptr, *tgt_state_ptr, res->getModel(),
+                         var_name, check_each_var, print_var_val);
+  });
   return false;
 }
 
@@ -253,7 +274,9 @@ static void instantiate_undef(const Input *in, map<expr, expr> &instances,
   }
 
   // Bail out if it gets too big. It's unlikely we can solve it anyway.
-  if (instances.size() >= 128 || hit_half_memory_limit())
+  auto pressure = memory_pressure();
+  if (instances.size() >= (pressure == MemoryPressure::None ? 128 : 16) ||
+      pressure >= MemoryPressure::Degrade)
     return;
 
   auto var = in->getUndefVar(ty, child);
@@ -269,7 +292,7 @@ static void instantiate_undef(const Input *in, map<expr, expr> &instances,
   for (auto I = instances.begin(); I != instances.end();
        I = instances.erase(I)) {
 
-    if (hit_half_memory_limit()) {
+    if (memory_pressure() >= MemoryPressure::Degrade) {
       instances2.insert(instances.begin(), instances.end());
       break;
     }
@@ -295,7 +318,7 @@ static void instantiate_undef(const Input *in, map<expr, expr> &instances,
 
 static expr preprocess(const Transform &t, const set<expr> &qvars0,
                        const set<expr> &undef_qvars, expr &&e) {
-  if (hit_half_memory_limit())
+  if (memory_pressure() >= MemoryPressure::Degrade)
     return expr::mkForAll(qvars0, std::move(e));
 
   // eliminate all quantified boolean vars; Z3 gets too slow with those
@@ -307,7 +330,7 @@ static expr preprocess(const Transform &t, const set<expr> &qvars0,
       ++I;
       continue;
     }
-    if (hit_half_memory_limit())
+    if (memory_pressure() >= MemoryPressure::Degrade)
       break;
 
     e = (e.subst(var, true) && e.subst(var, false)).simplify();
@@ -319,7 +342,7 @@ static expr preprocess(const Transform &t, const set<expr> &qvars0,
   }
 
   if (config::disable_undef_input || undef_qvars.empty() ||
-      hit_half_memory_limit())
+      memory_pressure() >= MemoryPressure::Degrade)
     return expr::mkForAll(qvars, std::move(e));
 
   // manually instantiate undef masks
@@ -359,8 +382,11 @@ encode_undef_refinement_per_elem(const Type &ty, const StateValue &sva,
 }
 
 // Returns negation of refinement
+// If lanes is given and type is an aggregate, it also receives the negation
+// of refinement of each (top-level) element; their disjunction is the result.
 static expr encode_undef_refinement(const Type &type, const State::ValTy &a,
-                                    const State::ValTy &b) {
+                                    const State::ValTy &b,
+                                    vector<expr> *lanes = nullptr) {
   // Undef refinement: (src-nonpoison /\ src-nonundef) -> tgt-nonundef
   //
   // Full refinement formula:
@@ -382,15 +408,93 @@ static expr encode_undef_refinement(const Type &type, const State::ValTy &a,
     return val.val.value.subst(repls);
   };
 
-  return encode_undef_refinement_per_elem(type, a.val, subst(a),
-                                          expr(b.val.value), subst(b));
+  const auto *aty = lanes ? type.getAsAggregateType() : nullptr;
+  if (!aty)
+    return encode_undef_refinement_per_elem(type, a.val, subst(a),
+                                            expr(b.val.value), subst(b));
+
+  StateValue sva2{subst(a), expr()};
+  StateValue svb{expr(b.val.value), expr()}, svb2{subst(b), expr()};
+  expr result = false;
+
+  for (unsigned i = 0; i < aty->numElementsConst(); ++i) {
+    if (aty->isPadding(i)) {
+      lanes->emplace_back(false);
+      continue;
+    }
+    lanes->emplace_back(encode_undef_refinement_per_elem(aty->getChild(i),
+                          aty->extract(a.val, i), aty->extract(sva2, i).value,
+                          aty->extract(svb, i).value,
+                          aty->extract(svb2, i).value));
+    result |= lanes->back();
+  }
+  return result;
+}
+
+static unsigned num_sliced_queries = 0;
+static uint64_t num_axioms = 0;
+static uint64_t num_axioms_dropped = 0;
+static unsigned num_memory_block_queries = 0;
+static unsigned num_lane_queries = 0;
+
+namespace {
+// Cone-of-influence slicing of the axioms: an axiom that doesn't share any
+// symbol (variable or uninterpreted function) with a query, even through
+// other axioms, can't change its satisfiability, since axioms are
+// satisfiable by construction.
+class AxiomSlicer {
+  vector<pair<expr, set<expr>>> axioms;
+
+  static set<expr> symbols(const expr &e) {
+    return expr::vars({ &e }, true);
+  }
+
+public:
+  AxiomSlicer(const AndExpr &and_axioms) {
+    for (auto &ax : and_axioms) {
+      axioms.emplace_back(ax, symbols(ax));
+    }
+  }
+
+  expr operator()(const expr &fml) const {
+    auto syms = symbols(fml);
+    vector<bool> taken(axioms.size());
+    AndExpr ret;
+    bool changed;
+    do {
+      changed = false;
+      for (unsigned i = 0, e = axioms.size(); i != e; ++i) {
+        auto &[ax, ax_syms] = axioms[i];
+        if (taken[i])
+          continue;
+        // closed axioms (e.g., false) are always kept
+        if (!ax_syms.empty() &&
+            none_of(ax_syms.begin(), ax_syms.end(),
+                    [&](auto &v) { return syms.count(v); }))
+          continue;
+        taken[i] = true;
+        changed  = true;
+        syms.insert(ax_syms.begin(), ax_syms.end());
+        ret.add(ax);
+      }
+    } while (changed);
+
+    ++num_sliced_queries;
+    num_axioms += axioms.size();
+    num_axioms_dropped += axioms.size() - ret.size();
+    return ret();
+  }
+};
 }
 
 static void
-check_refinement(Errors &errs, const Transform &t, State &src_state,
-                 State &tgt_state, const Value *var, const Type &type,
-                 const State::ValTy &ap, const State::ValTy &bp,
-                 bool check_each_var) {
+check_refinement(Errors &errs, const Transform &t,
+                 const shared_ptr<State> &src_state_ptr,
+                 const shared_ptr<State> &tgt_state_ptr, const Value *var,
+                 const Type &type, const State::ValTy &ap,
+                 const State::ValTy &bp, bool check_each_var) {
+  auto &src_state = *src_state_ptr;
+  auto &tgt_state = *tgt_state_ptr;
   auto &fndom_a  = ap.domain;
   auto &fndom_b  = bp.domain;
   auto &retdom_a = ap.return_domain;
@@ -407,6 +511,7 @@ check_refinement(Errors &errs, const Transform &t, State &src_state,
   AndExpr axioms = src_state.getAxioms();
   axioms.add(tgt_state.getAxioms());
   expr axioms_expr = axioms();
+  AxiomSlicer slice_axioms(axioms);
 
   // note that precondition->toSMT() may add stuff to getPre,
   // so order here matters
@@ -468,16 +573,25 @@ check_refinement(Errors &errs, const Transform &t, State &src_state,
     if (refines.isFalse())
       return std::move(refines);
 
-    return axioms_expr &&
-            preprocess(t, qvars, uvars, pre && pre_src_forall.implies(refines));
+    auto fml
+      = preprocess(t, qvars, uvars, pre && pre_src_forall.implies(refines));
+    return slice_axioms(fml) && fml;
   };
 
   auto check = [&](expr &&e, auto &&printer, const char *msg) {
-    e = mk_fml(std::move(e));
-    auto res = check_expr(e);
+    ScopedStage stage(msg);
+    Result res;
+    {
+      ScopedStage stage("qe");
+      e = mk_fml(std::move(e));
+    }
+    {
+      ScopedStage stage("smt");
+      res = check_expr(e);
+    }
     if (!res.isUnsat() &&
-        !error(errs, src_state, tgt_state, res, var, msg, check_each_var,
-               printer))
+        !error(errs, src_state_ptr, tgt_state_ptr, std::move(res), var, msg,
+               check_each_var, printer))
       return false;
     return true;
   };
@@ -486,6 +600,35 @@ check_refinement(Errors &errs, const Transform &t, State &src_state,
   if (!check(fml, printer, msg)) \
     return
 
+  // Checks a negated refinement given as a disjunction of parts: it fails iff
+  // some part is SAT. Each part is a query on its own, so that a hard part
+  // only times out itself, and the first failing part is reported.
+  auto check_split = [&](const vector<expr> &parts, auto &&printer,
+                         const char *msg, unsigned &num_queries) {
+    ScopedStage stage(msg);
+    bool timeout = false;
+    for (unsigned i = 0, e = parts.size(); i != e; ++i) {
+      if (parts[i].isFalse())
+        continue;
+      ++num_queries;
+      Result res = check_expr(mk_fml(expr(parts[i])));
+      if (res.isUnsat())
+        continue;
+      if (res.isTimeout()) {
+        timeout = true;
+        continue;
+      }
+      if (!error(errs, src_state_ptr, tgt_state_ptr, std::move(res), var, msg,
+                 check_each_var, printer(i)))
+        return false;
+    }
+    if (timeout) {
+      errs.add("Timeout", false);
+      return false;
+    }
+    return true;
+  };
+
   // 1. Check UB
   CHECK(fndom_a.notImplies(fndom_b),
         [](ostream&, const Model&){}, "Source is more defined than target");
@@ -505,37 +648,86 @@ check_refinement(Errors &errs, const Transform &t, State &src_state,
   }
 
   // 3. Check poison
-  auto print_value = [&](ostream &s, const Model &m) {
+  // printers may run after this function returns, so capture by value
+  auto print_value = [&src_state, &tgt_state, var, &type, a = a, b = b]
+                     (ostream &s, const Model &m) {
     s << "Source value: ";
     print_model_val(s, src_state, m, var, type, a);
     s << "\nTarget value: ";
     print_model_val(s, tgt_state, m, var, type, b);
   };
 
-  auto [poison_cnstr, value_cnstr] = type.refines(src_state, tgt_state, a, b);
   expr dom = retdom_a && retdom_b;
   if (check_each_var)
     dom &= fndom_a && fndom_b;
 
-  CHECK(dom && !poison_cnstr,
-        print_value, "Target is more poisonous than source");
+  expr poison_cnstr, value_cnstr;
+  const auto *lanes_ty
+    = config::split_lane_check ? type.getAsAggregateType() : nullptr;
 
-  // 4. Check undef
-  CHECK(dom && encode_undef_refinement(type, ap, bp),
-        print_value, "Target's return value is more undefined");
+  if (!lanes_ty) {
+    tie(poison_cnstr, value_cnstr) = type.refines(src_state, tgt_state, a, b);
 
-  // 5. Check value
-  CHECK(dom && !value_cnstr, print_value, "Value mismatch");
+    CHECK(dom && !poison_cnstr,
+          print_value, "Target is more poisonous than source");
+
+    // 4. Check undef
+    CHECK(dom && encode_undef_refinement(type, ap, bp),
+          print_value, "Target's return value is more undefined");
+
+    // 5. Check value
+    CHECK(dom && !value_cnstr, print_value, "Value mismatch");
+  } else {
+    // Same as above, but with one query per element
+    vector<expr> poison_lanes, undef_lanes, value_lanes;
+    set<expr> poison, value;
+    for (unsigned i = 0, e = lanes_ty->numElementsConst(); i != e; ++i) {
+      auto [p, v] = lanes_ty->getChild(i).refines(src_state, tgt_state,
+                                                  lanes_ty->extract(a, i),
+                                                  lanes_ty->extract(b, i));
+      poison_lanes.emplace_back(dom && !p);
+      value_lanes.emplace_back(dom && !v);
+      poison.emplace(std::move(p));
+      value.emplace(std::move(v));
+    }
+    poison_cnstr = expr::mk_and(poison);
+    value_cnstr  = expr::mk_and(value);
+
+    encode_undef_refinement(type, ap, bp, &undef_lanes);
+    for (auto &e : undef_lanes) {
+      e = dom && e;
+    }
+
+    auto print_lane = [&print_value](unsigned i) {
+      return [print_value, i](ostream &s, const Model &m) {
+        print_value(s, m);
+        s << "\nMismatch in element #" << i;
+      };
+    };
+
+    if (!check_split(poison_lanes, print_lane,
+                     "Target is more poisonous than source",
+                     num_lane_queries) ||
+        !check_split(undef_lanes, print_lane,
+                     "Target's return value is more undefined",
+                     num_lane_queries) ||
+        !check_split(value_lanes, print_lane, "Value mismatch",
+                     num_lane_queries))
+      return;
+  }
 
   // 6. Check memory
   auto &src_mem = src_state.returnMemory();
   auto &tgt_mem = tgt_state.returnMemory();
+  vector<expr> blocks_cnstr;
   auto [memory_cnstr0, ptr_refinement0, mem_undef]
-    = src_mem.refined(tgt_mem, false);
-  auto &ptr_refinement = ptr_refinement0;
+    = src_mem.refined(tgt_mem, false, nullptr, nullptr,
+                      config::split_memory_check ? &blocks_cnstr : nullptr);
+  auto ptr_refinement = ptr_refinement0;
   qvars.insert(mem_undef.begin(), mem_undef.end());
 
-  auto print_ptr_load = [&](ostream &s, const Model &m) {
+  auto print_ptr_load = [&src_mem, &tgt_mem, ptr_refinement]
+                        (ostream &s, const Model &m) {
     set<expr> undef;
     Pointer p(src_mem, m[ptr_refinement()]);
     s << "\nMismatch in " << p
@@ -543,9 +735,20 @@ check_refinement(Errors &errs, const Transform &t, State &src_state,
       << "\nTarget value: " << Byte(tgt_mem, m[tgt_mem.raw_load(p, undef)()]);
   };
 
-  CHECK(dom && !(memory_cnstr0.isTrue() ? memory_cnstr0
-                                        : value_cnstr && memory_cnstr0),
-        print_ptr_load, "Mismatch in memory");
+  if (!config::split_memory_check) {
+    CHECK(dom && !(memory_cnstr0.isTrue() ? memory_cnstr0
+                                          : value_cnstr && memory_cnstr0),
+          print_ptr_load, "Mismatch in memory");
+    return;
+  }
+
+  // The refinement pointer's bid is existentially quantified, so the memory
+  // check fails iff it fails for some block.
+  for (auto &blk : blocks_cnstr) {
+    blk = blk.isTrue() ? expr(false) : dom && !(value_cnstr && blk);
+  }
+  check_split(blocks_cnstr, [&](unsigned) { return print_ptr_load; },
+              "Mismatch in memory", num_memory_block_queries);
 
 #undef CHECK
 }
@@ -745,6 +948,244 @@ struct CountMemBlock {
 };
 }
 
+namespace {
+// Signed intervals of the values that integer instructions may take.
+// Since the IR is in SSA form (and loops are unrolled), ranges are
+// flow-insensitive and kept in the global data.
+class ValueRanges {
+  using Range = pair<__int128, __int128>;
+  unordered_map<const Value*, Range> ranges;
+
+  static unsigned int_bits(const Value &v) {
+    auto ty = dynamic_cast<const IntType*>(&v.getType());
+    return ty ? ty->bits() : 0;
+  }
+
+  static Range full(unsigned bits) {
+    __int128 one = 1;
+    return { -(one << (bits - 1)), (one << (bits - 1)) - 1 };
+  }
+
+  static Range fit(const Range &r, unsigned bits) {
+    auto f = full(bits);
+    return r.first >= f.first && r.second <= f.second ? r : f;
+  }
+
+  static Range join(const Range &a, const Range &b) {
+    return { min(a.first, b.first), max(a.second, b.second) };
+  }
+
+  Range get(const Value &v) const {
+    auto bits = int_bits(v);
+    assert(bits > 0 && bits <= 64);
+    if (auto n = getInt(v)) {
+      // constants may be stored zero-extended
+      int64_t val = bits == 64 ? *n : (int64_t)((uint64_t)*n << (64 - bits))
+                                        >> (64 - bits);
+      return { val, val };
+    }
+    auto I = ranges.find(&v);
+    return I != ranges.end() ? I->second : full(bits);
+  }
+
+  optional<Range> binop(const BinOp &i, unsigned bits) const {
+    auto [a, b] = pair(get(i.getLHS()), get(i.getRHS()));
+    bool a_pos = a.first >= 0, b_pos = b.first >= 0;
+
+    switch (i.getOp()) {
+    case BinOp::Add:
+      return fit({ a.first + b.first, a.second + b.second }, bits);
+    case BinOp::Sub:
+      return fit({ a.first - b.second, a.second - b.first }, bits);
+    case BinOp::Mul: {
+      __int128 p[] = { a.first * b.first, a.first * b.second,
+                       a.second * b.first, a.second * b.second };
+      return fit({ *min_element(p, p + 4), *max_element(p, p + 4) }, bits);
+    }
+    case BinOp::UDiv:
+    case BinOp::LShr:
+      if (a_pos)
+        return Range(0, a.second);
+      break;
+    case BinOp::URem:
+      if (b_pos && b.second > 0)
+        return Range(0, a_pos ? min(a.second, b.second - 1) : b.second - 1);
+      break;
+    case BinOp::Shl:
+      if (a_pos && b.first == b.second && b.first < bits)
+        return fit({ a.first << (int)b.first, a.second << (int)b.first },
+                   bits);
+      break;
+    case BinOp::And:
+      if (a_pos || b_pos)
+        return Range(0, min(a_pos ? a.second : b.second,
+                            b_pos ? b.second : a.second));
+      break;
+    case BinOp::UMin:
+      if (a_pos && b_pos)
+        return Range(min(a.first, b.first), min(a.second, b.second));
+      if (a_pos || b_pos)
+        return Range(0, a_pos ? a.second : b.second);
+      break;
+    case BinOp::UMax:
+      if (a_pos && b_pos)
+        return Range(max(a.first, b.first), max(a.second, b.second));
+      break;
+    case BinOp::SMin:
+      return Range(min(a.first, b.first), min(a.second, b.second));
+    case BinOp::SMax:
+      return Range(max(a.first, b.first), max(a.second, b.second));
+    case BinOp::Cttz:
+    case BinOp::Ctlz:
+      return fit({ 0, int_bits(i.getLHS()) }, bits);
+    default:
+      break;
+    }
+    return {};
+  }
+
+public:
+  void exec(const Instr &i, ValueRanges &glb) {
+    auto bits = int_bits(i);
+    if (bits == 0 || bits > 64)
+      return;
+
+    optional<Range> r;
+    if (auto bop = dynamic_cast<const BinOp*>(&i)) {
+      // overflow intrinsics return aggregates; they are skipped above
+      r = glb.binop(*bop, bits);
+    }
+    else if (auto conv = dynamic_cast<const ConversionOp*>(&i)) {
+      auto &val = conv->getValue();
+      auto vbits = int_bits(val);
+      if (vbits == 0 || vbits > 64)
+        return;
+
+      switch (conv->getOp()) {
+      case ConversionOp::SExt:
+        r = glb.get(val);
+        break;
+      case ConversionOp::ZExt:
+        r = glb.get(val);
+        if (r->first < 0)
+          r = Range(0, (__int128(1) << vbits) - 1);
+        break;
+      case ConversionOp::Trunc:
+        r = fit(glb.get(val), bits);
+        break;
+      default:
+        break;
+      }
+    }
+    else if (auto sel = dynamic_cast<const Select*>(&i)) {
+      r = join(glb.get(*sel->getTrueValue()), glb.get(*sel->getFalseValue()));
+    }
+    else if (auto phi = dynamic_cast<const Phi*>(&i)) {
+      for (auto &[val, bb] : phi->getValues()) {
+        auto vr = glb.get(*val);
+        r = r ? join(*r, vr) : vr;
+      }
+    }
+
+    if (r)
+      glb.ranges[&i] = *r;
+  }
+
+  void merge(const ValueRanges &other) {}
+
+  // upper bound of the value of an integer when interpreted as unsigned
+  uint64_t umax(const Value &v) const {
+    auto bits = int_bits(v);
+    if (bits == 0 || bits > 64)
+      return UINT64_MAX;
+    auto r = get(v);
+    if (r.first >= 0)
+      return r.second;
+    return bits == 64 ? UINT64_MAX : (1ull << bits) - 1;
+  }
+
+  // upper bound of the absolute value of an integer
+  uint64_t absmax(const Value &v) const {
+    auto bits = int_bits(v);
+    if (bits == 0 || bits > 64)
+      return UINT64_MAX;
+    auto r = get(v);
+    return max(r.first < 0 ? -r.first : r.first,
+               r.second < 0 ? -r.second : r.second);
+  }
+};
+}
+
+static uint64_t
+bounded_gep_offset(const GEP &gep, const ValueRanges &ranges) {
+  uint64_t off = 0;
+  for (auto &[mul, v] : gep.getIdxs()) {
+    off = add_saturate(off, mul_saturate(mul, ranges.absmax(*v)));
+  }
+  return min(off, gep.getMaxGEPOffset());
+}
+
+static pair<uint64_t, uint64_t>
+bounded_alloc_size(const MemInstr &i, const ValueRanges &ranges) {
+  auto [alloc, align] = i.getMaxAllocSize();
+  if (alloc != UINT64_MAX)
+    return { alloc, align };
+
+  if (auto a = dynamic_cast<const Alloc*>(&i)) {
+    alloc = ranges.umax(a->getSize());
+    if (auto mul = a->getMul())
+      alloc = mul_saturate(alloc, ranges.umax(*mul));
+  }
+  else if (auto call = dynamic_cast<const FnCall*>(&i)) {
+    auto &attrs = call->getAttributes();
+    auto &args = call->getArgs();
+    alloc = ranges.umax(*args[attrs.allocsize_0].first);
+    if (attrs.allocsize_1 != -1u)
+      alloc = mul_saturate(alloc, ranges.umax(*args[attrs.allocsize_1].first));
+  }
+  return { alloc, align };
+}
+
+static uint64_t
+bounded_access_size(const MemInstr &i, const ValueRanges &ranges) {
+  auto sz = i.getMaxAccessSize();
+  if (auto m = dynamic_cast<const Memset*>(&i))
+    sz = min(sz, ranges.umax(m->getBytes()));
+  else if (auto m = dynamic_cast<const Memcpy*>(&i))
+    sz = min(sz, ranges.umax(m->getBytes()));
+  else if (auto m = dynamic_cast<const Memcmp*>(&i))
+    sz = min(sz, ranges.umax(m->getBytes()));
+  return sz;
+}
+
+// Largest address that an int2ptr/ptr2int may expose, given the range of the
+// casted integer. For ptr2int, only the bits demanded by the users matter.
+static uint64_t max_casted_address(const Function &fn, const ConversionOp &i,
+                                   const ValueRanges &ranges) {
+  if (i.getOp() == ConversionOp::Int2Ptr)
+    return ranges.umax(i.getValue());
+
+  unsigned demanded = 0;
+  for (auto &user : fn.instrs()) {
+    auto ops = user.operands();
+    if (find(ops.begin(), ops.end(), &i) == ops.end())
+      continue;
+
+    // the low bits of an address are fine, e.g., for alignment checks
+    if (auto bop = dynamic_cast<const BinOp*>(&user);
+        bop && bop->getOp() == BinOp::And) {
+      auto mask = ranges.umax(&bop->getLHS() == &i ? bop->getRHS()
+                                                   : bop->getLHS());
+      demanded = max(demanded, (unsigned)bit_width(mask));
+    } else if (auto c = isCast(ConversionOp::Trunc, user)) {
+      demanded = max(demanded, c->getType().bits());
+    } else {
+      return UINT64_MAX;
+    }
+  }
+  return demanded >= 64 ? UINT64_MAX : (1ull << demanded) - 1;
+}
+
 
 static void initBitsProgramPointer(Transform &t) {
   // FIXME: varies among address spaces
@@ -854,6 +1295,9 @@ void calculateAndInitConstants(Transform &t) {
     uint64_t &loc_alloc_aligned_size
       = is_src ? loc_src_alloc_aligned_size : loc_tgt_alloc_aligned_size;
 
+    DenseDataFlow<ValueRanges> df(*fn);
+    auto &ranges = df.getGlobalResult();
+
     for (auto &v : fn->getInputs()) {
       auto *i = dynamic_cast<const Input *>(&v);
       if (!i)
@@ -910,12 +1354,16 @@ void calculateAndInitConstants(Transform &t) {
       }
 
       if (auto *mi = dynamic_cast<const MemInstr *>(&i)) {
-        auto [alloc, align] = mi->getMaxAllocSize();
+        auto [alloc, align] = bounded_alloc_size(*mi, ranges);
         max_alloc_size     = max(max_alloc_size, alloc);
         loc_alloc_aligned_size = add_saturate(loc_alloc_aligned_size,
                                               aligned_alloc_size(alloc, align));
-        max_access_size  = max(max_access_size, mi->getMaxAccessSize());
-        cur_max_gep      = add_saturate(cur_max_gep, mi->getMaxGEPOffset());
+        max_access_size  = max(max_access_size,
+                               bounded_access_size(*mi, ranges));
+        auto *gep        = dynamic_cast<const GEP*>(&i);
+        cur_max_gep      = add_saturate(cur_max_gep,
+                                        gep ? bounded_gep_offset(*gep, ranges)
+                                            : mi->getMaxGEPOffset());
 
         auto info = mi->getByteAccessInfo();
         has_ptr_load         |= info.doesPtrLoad;
@@ -932,8 +1380,13 @@ void calculateAndInitConstants(Transform &t) {
 
       } else if (isCast(ConversionOp::Int2Ptr, i) ||
                   isCast(ConversionOp::Ptr2Int, i)) {
-        max_alloc_size = max_access_size = cur_max_gep = loc_alloc_aligned_size
-          = UINT64_MAX;
+        // the pointer may be anywhere up to the largest casted address
+        auto addr = max_casted_address(*fn, static_cast<const ConversionOp&>(i),
+                                       ranges);
+        max_alloc_size  = max(max_alloc_size, addr);
+        max_access_size = max(max_access_size, addr);
+        cur_max_gep     = add_saturate(cur_max_gep, addr);
+        loc_alloc_aligned_size = add_saturate(loc_alloc_aligned_size, addr);
         has_int2ptr |= isCast(ConversionOp::Int2Ptr, i) != nullptr;
         has_ptr2int |= isCast(ConversionOp::Ptr2Int, i) != nullptr;
 
@@ -1094,6 +1547,13 @@ void calculateAndInitConstants(Transform &t) {
 
 namespace tools {
 
+static function<void(const StopWatch&)>
+record_stage(VerificationRecord *record, const char *stage) {
+  if (record)
+    return record->stage(stage);
+  return [](const StopWatch&) {};
+}
+
 TransformVerify::TransformVerify(Transform &t, bool check_each_var)
   : t(t), check_each_var(check_each_var) {
   if (check_each_var) {
@@ -1115,9 +1575,15 @@ pair<unique_ptr<State>, unique_ptr<State>> TransformVerify::exec() const {
 
   auto src_state = make_unique<State>(t.src, true);
   auto tgt_state = make_unique<State>(t.tgt, false);
-  sym_exec(*src_state);
+  {
+    ScopedStage stage("src");
+    sym_exec(*src_state);
+  }
   tgt_state->syncSEdataWithSrc(*src_state);
-  sym_exec(*tgt_state);
+  {
+    ScopedStage stage("tgt");
+    sym_exec(*tgt_state);
+  }
   src_state->mkAxioms(*tgt_state);
 
   return { std::move(src_state), std::move(tgt_state) };
@@ -1194,29 +1660,48 @@ Errors TransformVerify::verify() const {
   }
 
   Errors errs;
+  reset_memory_pressure();
   try {
-    auto [src_state, tgt_state] = exec();
+    optional<ScopedWatch> watch(record_stage(record, "vcgen"));
+    optional<ScopedStage> stage(in_place, "vcgen");
+    auto [src_state0, tgt_state0] = exec();
+    shared_ptr<State> src_state = std::move(src_state0);
+    shared_ptr<State> tgt_state = std::move(tgt_state0);
+    watch.emplace(record_stage(record, "refinement"));
+    stage.reset();
+    stage.emplace("refinement");
+
+    // the per-variable checks are only a debugging aid; drop them first
+    bool each_var = check_each_var;
+    if (each_var && memory_pressure() >= MemoryPressure::Degrade) {
+      dbg() << "WARNING: low on memory; skipping per-variable checks\n";
+      each_var = false;
+    }
 
-    if (check_each_var) {
+    if (each_var) {
       for (auto &[var, val] : src_state->getValues()) {
         auto &name = var->getName();
         if (name[0] != '%' || !dynamic_cast<const Instr*>(var))
           continue;
 
         auto &val_tgt = tgt_state->at(*tgt_instrs.at(name));
-        check_refinement(errs, t, *src_state, *tgt_state, var, var->getType(),
-                         val, val_tgt, check_each_var);
+        check_refinement(errs, t, src_state, tgt_state, var, var->getType(),
+                         val, val_tgt, each_var);
         if (errs)
-          return errs;
+          break;
       }
     }
 
-    check_refinement(errs, t, *src_state, *tgt_state, nullptr, t.src.getType(),
-                     src_state->returnVal(), tgt_state->returnVal(),
-                     check_each_var);
+    if (!errs)
+      check_refinement(errs, t, src_state, tgt_state, nullptr,
+                       t.src.getType(), src_state->returnVal(),
+                       tgt_state->returnVal(), each_var);
   } catch (AliveException e) {
-    return std::move(e);
+    errs = std::move(e);
   }
+
+  if (record)
+    record->mem_pressure = max(record->mem_pressure, max_memory_pressure());
   return errs;
 }
 
@@ -1248,14 +1733,24 @@ void TypingAssignments::operator++(void) {
 }
 
 TypingAssignments TransformVerify::getTypings() const {
-  auto c = t.src.getTypeConstraints() && t.tgt.getTypeConstraints();
+  ScopedWatch watch(record_stage(record, "typing"));
+  ScopedStage stage("typing");
+
+  // return type
+  auto c = t.src.getType() == t.tgt.getType();
+
+  // Well-typed functions with concrete types have exactly one typing, so
+  // skip building the constraints (and the solver query) altogether
+  if (!t.precondition && !check_each_var &&
+      t.src.isWellTyped() && t.tgt.isWellTyped() &&
+      t.src.hasConcreteTypes() && t.tgt.hasConcreteTypes())
+    return { std::move(c) };
+
+  c &= t.src.getTypeConstraints() && t.tgt.getTypeConstraints();
 
   if (t.precondition)
     c &= t.precondition->getTypeConstraints();
 
-  // return type
-  c &= t.src.getType() == t.tgt.getType();
-
   if (check_each_var) {
     for (auto &i : t.src.instrs()) {
       if (!i.isVoid())
@@ -1437,7 +1932,289 @@ static void optimize_ptrcmp(Function &f) {
   }
 }
 
+static unsigned num_copies_propagated = 0;
+static unsigned num_consts_folded = 0;
+static unsigned num_cse = 0;
+static unsigned num_dead_instrs = 0;
+
+static const IntConst* get_int_const(const Value &v) {
+  auto *c = dynamic_cast<const IntConst*>(&v);
+  return c && c->getInt() && c->getType().isConcrete() &&
+         c->getType().isIntType() && c->bits() <= 64 ? c : nullptr;
+}
+
+static bool has_undef(const Value &v) {
+  if (dynamic_cast<const UndefValue*>(&v))
+    return true;
+  if (auto agg = dynamic_cast<const AggregateValue*>(&v)) {
+    for (auto val : agg->getVals()) {
+      if (has_undef(*val))
+        return true;
+    }
+  }
+  return false;
+}
+
+static bool has_float(const Type &t) {
+  if (t.isFloatType())
+    return true;
+  if (auto agg = t.getAsAggregateType()) {
+    for (unsigned i = 0, e = agg->numElementsConst(); i != e; ++i) {
+      if (has_float(agg->getChild(i)))
+        return true;
+    }
+  }
+  return false;
+}
+
+static uint64_t mask_bits(uint64_t v, unsigned bits) {
+  return bits == 64 ? v : v & ((uint64_t(1) << bits) - 1);
+}
+
+static int64_t sext_bits(uint64_t v, unsigned bits) {
+  return bits == 64 ? int64_t(v)
+                    : int64_t(v << (64 - bits)) >> (64 - bits);
+}
+
+// Folds an instruction whose operands are all (small) integer constants.
+// Only folds when the result is neither poison nor UB.
+static optional<uint64_t> fold_int(const Instr &i) {
+  if (!i.getType().isConcrete() || !i.getType().isIntType() ||
+      i.getType().bits() > 64)
+    return {};
+  unsigned bits = i.getType().bits();
+
+  if (auto *bop = dynamic_cast<const BinOp*>(&i)) {
+    auto *lhs = get_int_const(bop->getLHS());
+    auto *rhs = get_int_const(bop->getRHS());
+    if (!lhs || !rhs || bop->getFlags() != BinOp::None)
+      return {};
+    uint64_t a = mask_bits(*lhs->getInt(), bits);
+    uint64_t b = mask_bits(*rhs->getInt(), bits);
+    switch (bop->getOp()) {
+    case BinOp::Add: return a + b;
+    case BinOp::Sub: return a - b;
+    case BinOp::Mul: return a * b;
+    case BinOp::And: return a & b;
+    case BinOp::Or:  return a | b;
+    case BinOp::Xor: return a ^ b;
+    case BinOp::UDiv:
+      if (b == 0)
+        return {};
+      return a / b;
+    case BinOp::URem:
+      if (b == 0)
+        return {};
+      return a % b;
+    case BinOp::Shl:
+      if (b >= bits)
+        return {};
+      return a << b;
+    case BinOp::LShr:
+      if (b >= bits)
+        return {};
+      return a >> b;
+    case BinOp::AShr:
+      if (b >= bits)
+        return {};
+      return uint64_t(sext_bits(a, bits) >> b);
+    default:
+      return {};
+    }
+  }
+
+  if (auto *conv = dynamic_cast<const ConversionOp*>(&i)) {
+    auto *val = get_int_const(conv->getValue());
+    if (!val)
+      return {};
+    uint64_t a = mask_bits(*val->getInt(), val->bits());
+    switch (conv->getOp()) {
+    case ConversionOp::ZExt:
+    case ConversionOp::Trunc: return a;
+    case ConversionOp::SExt:  return uint64_t(sext_bits(a, val->bits()));
+    default:                  return {};
+    }
+  }
+
+  if (auto *icmp = dynamic_cast<const ICmp*>(&i)) {
+    auto ops = icmp->operands();
+    auto *lhs = get_int_const(*ops[0]);
+    auto *rhs = get_int_const(*ops[1]);
+    if (!lhs || !rhs)
+      return {};
+    unsigned opbits = lhs->bits();
+    uint64_t a = mask_bits(*lhs->getInt(), opbits);
+    uint64_t b = mask_bits(*rhs->getInt(), opbits);
+    int64_t sa = sext_bits(a, opbits), sb = sext_bits(b, opbits);
+    switch (icmp->getCond()) {
+    case ICmp::EQ:  return a == b;
+    case ICmp::NE:  return a != b;
+    case ICmp::SLE: return sa <= sb;
+    case ICmp::SLT: return sa < sb;
+    case ICmp::SGE: return sa >= sb;
+    case ICmp::SGT: return sa > sb;
+    case ICmp::ULE: return a <= b;
+    case ICmp::ULT: return a < b;
+    case ICmp::UGE: return a >= b;
+    case ICmp::UGT: return a > b;
+    case ICmp::Any: return {};
+    }
+  }
+  return {};
+}
+
+// Returns an existing value that is equivalent to i, if any
+static Value* simplify_instr(Function &f, const Instr &i) {
+  // copies and pointer to pointer bitcasts
+  if (auto *unop = dynamic_cast<const UnaryOp*>(&i)) {
+    // aggregates with non-constant elements aren't registered in the State
+    // and are only reachable through their copy
+    if (unop->getOp() == UnaryOp::Copy &&
+        !dynamic_cast<const AggregateValue*>(&unop->getValue())) {
+      ++num_copies_propagated;
+      return &unop->getValue();
+    }
+  }
+
+  if (auto *c = isCast(ConversionOp::BitCast, i)) {
+    if (i.getType().isPtrType() && c->getValue().getType().isPtrType()) {
+      ++num_copies_propagated;
+      return &c->getValue();
+    }
+  }
+
+  // select with a constant condition
+  if (auto *sel = dynamic_cast<const Select*>(&i)) {
+    auto *cond = get_int_const(*sel->operands()[0]);
+    if (cond && sel->getFastMathFlags().isNone()) {
+      ++num_consts_folded;
+      return mask_bits(*cond->getInt(), 1) ? sel->getTrueValue()
+                                           : sel->getFalseValue();
+    }
+  }
+
+  if (auto val = fold_int(i)) {
+    ++num_consts_folded;
+    unsigned bits = i.getType().bits();
+    auto c = make_unique<IntConst>(i.getType(),
+                                   (int64_t)mask_bits(*val, bits));
+    auto *ret = c.get();
+    f.addConstant(std::move(c));
+    return ret;
+  }
+  return nullptr;
+}
+
+// Returns a key that is equal for two instructions iff they compute the same
+// value given the same operands, or nullopt if the instruction is not
+// deterministic (e.g., freeze, undef operands, bitcasts of NaNs or nsz
+// selects) or may depend on memory.
+static optional<string> cse_key(const Instr &i) {
+  if (!i.getType().isConcrete())
+    return {};
+
+  if (auto *conv = dynamic_cast<const ConversionOp*>(&i)) {
+    if (conv->getOp() == ConversionOp::Ptr2Int ||
+        conv->getOp() == ConversionOp::Int2Ptr)
+      return {};
+    // float -> int picks a fresh NaN payload on each execution
+    if (conv->getOp() == ConversionOp::BitCast &&
+        has_float(conv->getValue().getType()))
+      return {};
+  } else if (auto *sel = dynamic_cast<const Select*>(&i)) {
+    // fast-math flags may pick the sign of zeros nondeterministically
+    if (!sel->getFastMathFlags().isNone())
+      return {};
+  } else if (auto *unop = dynamic_cast<const UnaryOp*>(&i)) {
+    if (unop->getOp() == UnaryOp::IsConstant)
+      return {};
+  } else if (auto *icmp = dynamic_cast<const ICmp*>(&i)) {
+    if (icmp->isPtrCmp() || icmp->getCond() == ICmp::Any)
+      return {};
+  } else if (!dynamic_cast<const BinOp*>(&i) &&
+             !dynamic_cast<const ExtractValue*>(&i) &&
+             !dynamic_cast<const InsertValue*>(&i)) {
+    return {};
+  }
+
+  for (auto *op : i.operands()) {
+    if (!op->getType().isConcrete() || has_undef(*op))
+      return {};
+  }
+
+  ostringstream os;
+  i.print(os);
+  auto str = std::move(os).str();
+  return str.substr(str.find(" = ") + 3);
+}
+
+// Poison- and undef-aware local simplifications: copy propagation, constant
+// folding, and common subexpression elimination within each basic block.
+// Instructions left without users are removed by the DCE that follows.
+static void simplify(Function &f) {
+  // replaced instr -> replacement; replacements are never replaced themselves
+  unordered_map<const Value*, Value*> repls;
+  auto replace_ops = [&](const Instr &i) {
+    for (auto *op : i.operands()) {
+      if (auto I = repls.find(op); I != repls.end())
+        const_cast<Instr&>(i).rauw(*op, *I->second);
+    }
+  };
+
+  for (auto bb : f.getBBs()) {
+    unordered_map<string, Instr*> exprs;
+    for (auto &i : bb->instrs()) {
+      replace_ops(i);
+      if (i.isVoid())
+        continue;
+
+      if (auto *v = simplify_instr(f, i)) {
+        repls.emplace(&i, v);
+        continue;
+      }
+
+      if (auto key = cse_key(i)) {
+        auto [I, inserted]
+          = exprs.try_emplace(std::move(*key), const_cast<Instr*>(&i));
+        if (!inserted) {
+          ++num_cse;
+          repls.emplace(&i, I->second);
+        }
+      }
+    }
+  }
+
+  // phis may use values defined later
+  if (!repls.empty()) {
+    for (auto &i : f.instrs()) {
+      replace_ops(i);
+    }
+  }
+}
+
+// Removes side-effect free instructions without users
+static bool remove_dead_instrs(Function &f, const Function::UsersTy &users) {
+  vector<Instr*> to_remove;
+  bool changed = false;
+  for (auto bb : f.getBBs()) {
+    for (auto &i : bb->instrs()) {
+      auto i_ptr = const_cast<Instr*>(&i);
+      if (hasNoSideEffects(i) && !users.count(i_ptr))
+        to_remove.emplace_back(i_ptr);
+    }
+
+    for (auto i : to_remove) {
+      bb->delInstr(i);
+      ++num_dead_instrs;
+      changed = true;
+    }
+    to_remove.clear();
+  }
+  return changed;
+}
+
 void Transform::preprocess() {
+  ScopedStage stage("preprocess");
   remove_unreachable_bbs(src);
   remove_unreachable_bbs(tgt);
 
@@ -1466,28 +2243,16 @@ void Transform::preprocess() {
   optimize_ptrcmp(src);
   optimize_ptrcmp(tgt);
 
+  // simplify the programs
+  simplify(src);
+  simplify(tgt);
+
   // remove side-effect free instructions without users
-  vector<Instr*> to_remove;
   for (auto fn : { &src, &tgt }) {
     bool changed;
     do {
       auto users = fn->getUsers();
-      changed = false;
-
-      for (auto bb : fn->getBBs()) {
-        for (auto &i : bb->instrs()) {
-          auto i_ptr = const_cast<Instr*>(&i);
-          if (hasNoSideEffects(i) && !users.count(i_ptr))
-            to_remove.emplace_back(i_ptr);
-        }
-
-        for (auto i : to_remove) {
-          bb->delInstr(i);
-          changed = true;
-        }
-        to_remove.clear();
-      }
-
+      changed = remove_dead_instrs(*fn, users);
       changed |=
         fn->removeUnusedStuff(users, fn == &src ? vector<string_view>()
                                                 : src.getGlobalVarNames());
@@ -1499,6 +2264,105 @@ void Transform::preprocess() {
 
   src.unroll(config::src_unroll_cnt);
   tgt.unroll(config::tgt_unroll_cnt);
+
+  // unrolling may leave dead copies of instructions behind
+  for (auto [fn, cnt] : { make_pair(&src, config::src_unroll_cnt),
+                          make_pair(&tgt, config::tgt_unroll_cnt) }) {
+    if (cnt > 0) {
+      while (remove_dead_instrs(*fn, fn->getUsers()));
+    }
+  }
+}
+
+// Aligns tgt with src positionally (inputs, blocks, and the instructions
+// within each block) and renames the names of tgt to those of src.
+// Returns false if the programs don't have the same shape.
+static bool align_names(const Function &src, const Function &tgt,
+                        unordered_map<string, string> &names,
+                        set<string_view> &used) {
+  auto add = [&](const string &from, const string &to) {
+    auto [I, inserted] = names.try_emplace(from, to);
+    return inserted ? used.emplace(to).second : I->second == to;
+  };
+
+  auto zip = [&](const auto &a, const auto &b, auto fn) {
+    auto I = a.begin(), E = a.end();
+    auto II = b.begin(), EE = b.end();
+    for (; I != E && II != EE; ++I, ++II) {
+      if (!fn(*I, *II))
+        return false;
+    }
+    return !(I != E) && !(II != EE);
+  };
+
+  return
+    zip(src.getInputs(), tgt.getInputs(),
+        [&](auto &s, auto &t) { return add(t.getName(), s.getName()); }) &&
+    zip(src.getBBs(), tgt.getBBs(), [&](auto *sbb, auto *tbb) {
+      return add(tbb->getName(), sbb->getName()) &&
+             zip(sbb->instrs(), tbb->instrs(), [&](auto &s, auto &t) {
+               return s.getName().empty() == t.getName().empty() &&
+                      (s.getName().empty() || add(t.getName(), s.getName()));
+             });
+    });
+}
+
+static bool is_name_char(char c) {
+  return isalnum((unsigned char)c) || c == '_' || c == '.' || c == '$' ||
+         c == '#' || c == '-';
+}
+
+// Returns false if an unaligned name of tgt clashes with a name of src
+static bool rename(const string &str, string &ret,
+                   const unordered_map<string, string> &names,
+                   const set<string_view> &used) {
+  ret.reserve(str.size());
+  for (size_t i = 0, e = str.size(); i < e; ) {
+    if (str[i] != '%' && str[i] != '#') {
+      ret += str[i++];
+      continue;
+    }
+    size_t end = i + 1;
+    while (end < e && is_name_char(str[end]))
+      ++end;
+    string tok = str.substr(i, end - i);
+    if (auto I = names.find(tok); I != names.end())
+      ret += I->second;
+    else if (used.count(tok))
+      return false;
+    else
+      ret += tok;
+    i = end;
+  }
+  return true;
+}
+
+bool Transform::isAlphaEquivalent(const string &src_str,
+                                  const string &tgt_str) const {
+  unordered_map<string, string> names;
+  set<string_view> used;
+  if (!align_names(src, tgt, names, used))
+    return false;
+
+  string renamed;
+  return rename(tgt_str, renamed, names, used) && src_str == renamed;
+}
+
+void transform_print_stats(ostream &os) {
+  float dropped_pc = num_axioms == 0 ? 0
+                       : (num_axioms_dropped * 100.0) / num_axioms;
+  os << "\n------------------- SLICING STATS -------------------\n"
+        "Num sliced queries: " << num_sliced_queries << "\n"
+        "Num axioms:         " << num_axioms << "\n"
+        "Num axioms dropped: " << num_axioms_dropped << " (" << fixed
+     << setprecision(1) << dropped_pc << "%)\n"
+        "Num per-block memory queries: " << num_memory_block_queries << "\n"
+        "Num per-element value queries: " << num_lane_queries << "\n"
+        "\n------------------- PREPROCESS STATS -------------------\n"
+        "Num copies propagated: " << num_copies_propagated << "\n"
+        "Num consts folded:     " << num_consts_folded << "\n"
+        "Num CSE'd instrs:      " << num_cse << "\n"
+        "Num dead instrs:       " << num_dead_instrs << '\n';
 }
 
 void Transform::print(ostream &os, const TransformPrintOpts &opt) const {
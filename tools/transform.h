@@ -6,6 +6,7 @@
 #include "ir/function.h"
 #include "ir/state.h"
 #include "smt/solver.h"
+#include "tools/result_stream.h"
 #include "util/errors.h"
 #include <memory>
 #include <ostream>
@@ -27,6 +28,10 @@ struct Transform {
   IR::Predicate *precondition = nullptr;
 
   void preprocess();
+  // true if tgt is src up to a renaming of values and basic blocks, given
+  // the printed src and tgt
+  bool isAlphaEquivalent(const std::string &src_str,
+                         const std::string &tgt_str) const;
   void print(std::ostream &os, const TransformPrintOpts &opt) const;
   friend std::ostream& operator<<(std::ostream &os, const Transform &t);
 };
@@ -53,9 +58,12 @@ class TransformVerify {
   Transform &t;
   std::unordered_map<std::string, const IR::Instr*> tgt_instrs;
   bool check_each_var;
+  VerificationRecord *record = nullptr;
 
 public:
   TransformVerify(Transform &t, bool check_each_var);
+  // record the time taken by each verification stage
+  void setRecord(VerificationRecord *r) { record = r; }
   std::pair<std::unique_ptr<IR::State>,std::unique_ptr<IR::State>> exec() const;
   util::Errors verify() const;
   TypingAssignments getTypings() const;
@@ -67,4 +75,6 @@ void print_model_val(std::ostream &os, const IR::State &st, const smt::Model &m,
                      const IR::Value *var, const IR::Type &type,
                      const IR::StateValue &val, unsigned child = 0);
 
+void transform_print_stats(std::ostream &os);
+
 }
@@ -3,11 +3,13 @@
 
 #include "cache/cache.h"
 #include "ir/memory.h"
+#include "llvm_util/known_fns.h"
 #include "llvm_util/llvm2alive.h"
 #include "llvm_util/utils.h"
 #include "smt/smt.h"
 #include "smt/solver.h"
 #include "tools/transform.h"
+#include "util/crc.h"
 #include "util/parallel.h"
 #include "util/stopwatch.h"
 #include "util/version.h"
@@ -24,7 +26,9 @@
 #include "llvm/Transforms/Utils/Cloning.h"
 #include <fstream>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <optional>
 #include <random>
 #include <signal.h>
 #include <sstream>
@@ -87,13 +91,38 @@ unique_ptr<parallel> parallelMgr;
 stringstream parent_ss;
 std::unique_ptr<llvm::Module> MClone;
 string pass_name;
+// A child's timeout record is formatted before setting the alarm, as the
+// signal handler can't allocate memory
+string timeout_record;
+volatile sig_atomic_t reported_result = false;
 
 void sigalarm_handler(int) {
+  // only if the child didn't get to report a result already
+  if (!reported_result)
+    result_stream.writeRaw(timeout_record);
   parallelMgr->finishChild(/*is_timeout=*/true);
   // this is a fully asynchronous exit, skip destructors and such
   _Exit(0);
 }
 
+// A child with a timeout writes its record right away, and with the alarm
+// blocked, so that the signal handler doesn't report a timeout as well
+void writeResult(const VerificationRecord &rec) {
+  if (timeout_record.empty()) {
+    result_stream.write(rec);
+    return;
+  }
+
+  sigset_t alarm_set, old_set;
+  sigemptyset(&alarm_set);
+  sigaddset(&alarm_set, SIGALRM);
+  sigprocmask(SIG_BLOCK, &alarm_set, &old_set);
+  result_stream.write(rec);
+  result_stream.flush();
+  reported_result = true;
+  sigprocmask(SIG_SETMASK, &old_set, nullptr);
+}
+
 void printDot(const Function &tgt, int n) {
   if (opt_print_dot) {
     string prefix = to_string(n);
@@ -107,11 +136,24 @@ string toString(const Function &fn) {
   return std::move(ss).str();
 }
 
+crc128_t hash(const string &str) {
+  return crc128_finalize(crc128_update(crc128_init(), str.data(), str.size()));
+}
+
+// the printed function is needed for the syntactic check and the cache key
+bool needs_text() {
+  return !opt_always_verify || cache;
+}
+
 static void showStats() {
-  if (opt_smt_stats)
+  if (opt_smt_stats) {
     smt::solver_print_stats(*out);
+    tools::transform_print_stats(*out);
+  }
   if (opt_alias_stats)
     IR::Memory::printAliasStats(*out);
+  if (opt_known_fns_stats)
+    llvm_util::known_fns_print_stats(*out);
 }
 
 static void writeBitcodeAtomically(const fs::path report_filename) {
@@ -162,21 +204,103 @@ struct TVLegacyPass final : public llvm::ModulePass {
     = nullptr;
   unsigned anon_count;
 
+  // Translations done ahead of the verification loop, keyed by function and
+  // whether it's the translation of the function as src for the next pass
+  struct Translation {
+    optional<Function> fn;
+    string output; // printed by the translation
+  };
+  map<pair<const llvm::Function*, bool>, Translation> translated;
+
   TVLegacyPass() : ModulePass(ID) {}
 
   bool runOnModule(llvm::Module &M) override {
     anon_count = 0;
+    if (opt_translation_threads > 1)
+      translateAll(M);
     for (auto &F: M)
       runOnFunction(F);
+    translated.clear();
     return false;
   }
 
-  bool runOnFunction(llvm::Function &F) {
-    if (F.isDeclaration())
-      // This can happen at EntryExitInstrumenter pass.
-      return false;
+  llvm::TargetLibraryInfo* getTLI(llvm::Function &F) {
+    if (TLI_override) {
+      // When used as a clang plugin or from the new pass manager, this is run
+      // as a plain function rather than a registered pass, so getAnalysis()
+      // cannot be used.
+      return (*TLI_override)(F);
+    }
+    return &getAnalysis<llvm::TargetLibraryInfoWrapperPass>().getTLI(F);
+  }
 
-    if (!func_names.empty() && !func_names.count(F.getName().str()))
+  bool skipFunction(llvm::Function &F) const {
+    // Declarations can happen at EntryExitInstrumenter pass.
+    return F.isDeclaration() ||
+           (!func_names.empty() && !func_names.count(F.getName().str()));
+  }
+
+  // Translates the functions that runOnFunction will need, in parallel
+  void translateAll(llvm::Module &M) {
+    struct Job {
+      llvm::Function *F;
+      llvm::TargetLibraryInfo TLI;
+      bool is_src;
+      bool next_src;
+      vector<string_view> gvnames;
+    };
+    vector<Job> jobs;
+    unsigned anon = 0;
+
+    for (auto &F : M) {
+      if (skipFunction(F))
+        continue;
+
+      string name = F.getName().str();
+      if (name.empty())
+        name = "anon$" + std::to_string(++anon);
+      auto I = fns.find(name);
+      bool first = I == fns.end();
+      if (onlyif_src_exists && first)
+        continue;
+
+      // the TLI getters return storage that is reused on the next call
+      llvm::TargetLibraryInfo TLI = *getTLI(F);
+      jobs.push_back({ &F, TLI, first, false,
+                       first ? vector<string_view>()
+                             : I->second.fn.getGlobalVarNames() });
+      if (!first && !skip_verify)
+        jobs.push_back({ &F, TLI, true, true, {} });
+    }
+
+    ScopedStage stage("translation");
+    vector<optional<Function>> results(jobs.size());
+    auto outputs = llvm2alive_parallel(jobs.size(), opt_translation_threads,
+                                       [&](unsigned i) {
+      auto &job = jobs[i];
+      results[i] = llvm2alive(*job.F, job.TLI, job.is_src, job.gvnames);
+    });
+
+    for (unsigned i = 0, e = jobs.size(); i != e; ++i) {
+      translated.emplace(make_pair(jobs[i].F, jobs[i].next_src),
+                         Translation{ std::move(results[i]),
+                                      std::move(outputs[i]) });
+    }
+  }
+
+  optional<Function> translate(llvm::Function &F,
+                               const llvm::TargetLibraryInfo &TLI,
+                               bool is_src, bool next_src,
+                               const vector<string_view> &gvnames = {}) {
+    if (auto I = translated.find({ &F, next_src }); I != translated.end()) {
+      *out << I->second.output;
+      return std::move(I->second.fn);
+    }
+    return llvm2alive(F, TLI, is_src, gvnames);
+  }
+
+  bool runOnFunction(llvm::Function &F) {
+    if (skipFunction(F))
       return false;
 
     optional<ScopedWatch> timer;
@@ -185,15 +309,7 @@ struct TVLegacyPass final : public llvm::ModulePass {
         *out << "Took " << sw.seconds() << "s\n";
       });
 
-    llvm::TargetLibraryInfo *TLI = nullptr;
-    if (TLI_override) {
-      // When used as a clang plugin or from the new pass manager, this is run
-      // as a plain function rather than a registered pass, so getAnalysis()
-      // cannot be used.
-      TLI = (*TLI_override)(F);
-    } else {
-      TLI = &getAnalysis<llvm::TargetLibraryInfoWrapperPass>().getTLI(F);
-    }
+    llvm::TargetLibraryInfo *TLI = getTLI(F);
 
     string name = F.getName().str();
     if (name.empty())
@@ -205,9 +321,13 @@ struct TVLegacyPass final : public llvm::ModulePass {
       return false;
     }
 
-    auto fn = llvm2alive(F, *TLI, first,
-                         first ? vector<string_view>()
-                               : I->second.fn.getGlobalVarNames());
+    ScopedStage pass_stage(pass_name.empty() ? "<no pass>" : pass_name);
+    ScopedStage fn_stage(I->first);
+    optional<ScopedStage> stage(in_place, "translation");
+    auto fn = translate(F, *TLI, first, false,
+                        first ? vector<string_view>()
+                              : I->second.fn.getGlobalVarNames());
+    stage.reset();
     if (!fn) {
       fns.erase(I);
       return false;
@@ -215,7 +335,7 @@ struct TVLegacyPass final : public llvm::ModulePass {
 
     if (first || skip_verify) {
       I->second.fn = std::move(*fn);
-      if (!opt_always_verify)
+      if (needs_text())
         // Prepare syntactic check
         I->second.fn_tostr = toString(I->second.fn);
       printDot(I->second.fn, I->second.n++);
@@ -228,13 +348,14 @@ struct TVLegacyPass final : public llvm::ModulePass {
 
     verify(t, I->second.n++, I->second.fn_tostr);
 
-    fn = llvm2alive(F, *TLI, true);
+    stage.emplace("translation");
+    fn = translate(F, *TLI, true, true);
     if (!fn) {
       fns.erase(I);
       return false;
     }
     I->second.fn = std::move(*fn);
-    if (!opt_always_verify)
+    if (needs_text())
       I->second.fn_tostr = toString(I->second.fn);
     return false;
   }
@@ -242,25 +363,38 @@ struct TVLegacyPass final : public llvm::ModulePass {
   static void verify(Transform &t, int n, const string &src_tostr) {
     printDot(t.tgt, n);
 
-    auto tgt_tostr = toString(t.tgt);
+    VerificationRecord rec;
+    rec.function = t.src.getName();
+    rec.pass     = pass_name;
+    rec.report   = report_filename.string();
+
+    string tgt_tostr = needs_text() ? toString(t.tgt) : string();
     if (!opt_always_verify) {
       // Compare Alive2 IR and skip if syntactically equal
-      if (src_tostr == tgt_tostr) {
+      if (src_tostr == tgt_tostr ||
+          t.isAlphaEquivalent(src_tostr, tgt_tostr)) {
         if (!opt_quiet)
           t.print(*out, print_opts);
         *out << "Transformation seems to be correct! (syntactically equal)\n\n";
+        rec.status = VerificationRecord::SyntacticEq;
+        result_stream.write(rec);
         return;
       }
     }
 
     // Since we have an open connection to the Redis server, we have
     // to do this before forking. Anyway, this is fast.
-    if (cache && cache->lookup(src_tostr + "===\n" + tgt_tostr)) {
+    if (cache && cache->lookup(to_string(hash(src_tostr)) +
+                               to_string(hash(tgt_tostr)))) {
       *out << "Skipping repeated query\n\n";
+      rec.status = VerificationRecord::Skipped;
+      result_stream.write(rec);
       return;
     }
 
     if (parallelMgr) {
+      // don't let the child inherit (and write twice) our pending records
+      result_stream.flush();
       auto [pid, osp, index] = parallelMgr->limitedFork();
 
       if (pid == -1) {
@@ -284,9 +418,16 @@ struct TVLegacyPass final : public llvm::ModulePass {
       }
 
       if (subprocess_timeout != -1) {
+        // reported like a solver timeout
+        VerificationRecord timeout = rec;
+        timeout.status = VerificationRecord::FailedToProve;
+        timeout.error_class = "Timeout";
+        timeout_record = ResultStream::format(timeout);
         ENSURE(signal(SIGALRM, sigalarm_handler) == nullptr);
         alarm(subprocess_timeout);
       }
+      // the parent reports its own stage times
+      stage_times_clear();
 
       /*
        * child now writes to a stringstream provided by the parallel
@@ -303,8 +444,12 @@ struct TVLegacyPass final : public llvm::ModulePass {
      */
 
     smt_init->reset();
-    t.preprocess();
+    {
+      ScopedWatch watch(rec.stage("preprocess"));
+      t.preprocess();
+    }
     TransformVerify verifier(t, false);
+    verifier.setRecord(&rec);
     if (!opt_quiet)
       t.print(*out, print_opts);
 
@@ -313,12 +458,16 @@ struct TVLegacyPass final : public llvm::ModulePass {
       if (!types) {
         *out << "Transformation doesn't verify!\n"
                 "ERROR: program doesn't type check!\n\n";
+        rec.status = VerificationRecord::TypeCheckFailed;
+        writeResult(rec);
         goto done;
       }
       assert(types.hasSingleTyping());
     }
 
     if (Errors errs = verifier.verify()) {
+      rec.setErrors(errs);
+      writeResult(rec);
       *out << "Transformation doesn't verify!" <<
               (errs.isUnsound() ? " (unsound)\n" : " (not unsound)\n")
            << errs;
@@ -334,15 +483,19 @@ struct TVLegacyPass final : public llvm::ModulePass {
         finalize();
     } else {
       *out << "Transformation seems to be correct!\n\n";
+      rec.status = VerificationRecord::Correct;
+      writeResult(rec);
     }
 
   done:
     if (parallelMgr) {
       showStats();
       signal(SIGALRM, SIG_IGN);
+      result_stream.flush();
       llvm_util_init.reset();
       smt_init.reset();
       parallelMgr->finishChild(/*is_timeout=*/false);
+      stage_times_flush();
       exit(0);
     }
   }
@@ -395,6 +548,8 @@ struct TVLegacyPass final : public llvm::ModulePass {
 
   static void finalize() {
     MClone = nullptr;
+    result_stream.flush();
+    stage_times_flush();
     if (parallelMgr) {
       parallelMgr->finishParent();
       out = out_file.is_open() ? &out_file : &cout;
@@ -21,6 +21,14 @@ extern bool disable_undef_input;
 
 extern bool debug;
 
+// check memory refinement with one SMT query per block instead of a single
+// query over all blocks
+extern bool split_memory_check;
+
+// check the refinement of vector/aggregate values with one SMT query per
+// element instead of a single query over all elements
+extern bool split_lane_check;
+
 extern unsigned src_unroll_cnt;
 
 extern unsigned tgt_unroll_cnt;
@@ -11,16 +11,20 @@
  *  - ReflectIn     = True
  *  - XorOut        = 0x0000000000000000
  *  - ReflectOut    = True
- *  - Algorithm     = table-driven
+ *  - Algorithm     = table-driven (slicing-by-8)
  */
 #include "crc.h" /* include the header file generated with pycrc */
+#include <array>
+#include <cstdio>
+#include <cstring>
 #include <stdint.h>
 #include <stdlib.h>
 
 /**
  * Static table used for the table_driven implementation.
+ * The slicing-by-8 tables are derived from it.
  */
-static const crc_t crc_table[256] = {
+static constexpr uint64_t crc_table[256] = {
     0x0000000000000000, 0x01b0000000000000, 0x0360000000000000,
     0x02d0000000000000, 0x06c0000000000000, 0x0770000000000000,
     0x05a0000000000000, 0x0410000000000000, 0x0d80000000000000,
@@ -108,14 +112,143 @@ static const crc_t crc_table[256] = {
     0x9240000000000000, 0x93f0000000000000, 0x9120000000000000,
     0x9090000000000000};
 
+namespace {
+
+using slice_table = std::array<std::array<uint64_t, 256>, 8>;
+
+/* slice k gives the crc of a byte followed by k zero bytes */
+constexpr slice_table mk_slices(const uint64_t (&table)[256]) {
+  slice_table t = {};
+  for (unsigned i = 0; i < 256; ++i) {
+    t[0][i] = table[i];
+  }
+  for (unsigned k = 1; k < 8; ++k) {
+    for (unsigned i = 0; i < 256; ++i) {
+      t[k][i] = (t[k-1][i] >> 8) ^ t[0][t[k-1][i] & 0xff];
+    }
+  }
+  return t;
+}
+
+/* byte-wise table of a reflected crc with the given (reflected) polynomial */
+constexpr slice_table mk_slices(uint64_t poly) {
+  uint64_t table[256] = {};
+  for (unsigned i = 0; i < 256; ++i) {
+    uint64_t crc = i;
+    for (unsigned j = 0; j < 8; ++j) {
+      crc = (crc >> 1) ^ ((crc & 1) ? poly : 0);
+    }
+    table[i] = crc;
+  }
+  return mk_slices(table);
+}
+
+
+constexpr slice_table crc_slices = mk_slices(crc_table);
+/* CRC-64/XZ: ECMA-182 polynomial, reflected */
+constexpr slice_table xz_slices  = mk_slices(0xc96c5795d7870f42);
+
+static_assert(mk_slices(0xd800000000000000)[0][1] == crc_table[1]);
+
+inline uint64_t update_byte(const slice_table &t, uint64_t crc,
+                            unsigned char d) {
+  return t[0][(crc ^ d) & 0xff] ^ (crc >> 8);
+}
+
+inline uint64_t update_word(const slice_table &t, uint64_t crc, uint64_t w) {
+  crc ^= w;
+  return t[7][crc & 0xff]         ^ t[6][(crc >> 8) & 0xff]  ^
+         t[5][(crc >> 16) & 0xff] ^ t[4][(crc >> 24) & 0xff] ^
+         t[3][(crc >> 32) & 0xff] ^ t[2][(crc >> 40) & 0xff] ^
+         t[1][(crc >> 48) & 0xff] ^ t[0][crc >> 56];
+}
+
+inline uint64_t load_le64(const unsigned char *d) {
+  uint64_t w;
+  memcpy(&w, d, 8);
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  w = __builtin_bswap64(w);
+#endif
+  return w;
+}
+
+}
+
 crc_t crc_update(crc_t crc, const void *data, size_t data_len) {
   const unsigned char *d = (const unsigned char *)data;
-  unsigned int tbl_idx;
+  uint64_t c = crc;
+
+  for (; data_len >= 8; d += 8, data_len -= 8) {
+    c = update_word(crc_slices, c, load_le64(d));
+  }
+  while (data_len--) {
+    c = update_byte(crc_slices, c, *d++);
+  }
+  return c;
+}
+
+crc128_t crc128_update(crc128_t crc, const void *data, size_t data_len) {
+  const unsigned char *d = (const unsigned char *)data;
 
+  /* the two crcs are independent, so their updates can overlap */
+  for (; data_len >= 8; d += 8, data_len -= 8) {
+    uint64_t w = load_le64(d);
+    crc.lo = update_word(crc_slices, crc.lo, w);
+    crc.hi = update_word(xz_slices, crc.hi, w);
+  }
   while (data_len--) {
-    tbl_idx = (crc ^ *d) & 0xff;
-    crc = (crc_table[tbl_idx] ^ (crc >> 8)) & 0xffffffffffffffff;
-    d++;
+    crc.lo = update_byte(crc_slices, crc.lo, *d);
+    crc.hi = update_byte(xz_slices, crc.hi, *d++);
+  }
+  return crc;
+}
+
+
+namespace util {
+
+crc_ostream::buffer::buffer() {
+  setp(buf, buf + sizeof(buf));
+}
+
+void crc_ostream::buffer::sync_crc() {
+  crc = crc128_update(crc, pbase(), pptr() - pbase());
+  setp(buf, buf + sizeof(buf));
+}
+
+crc_ostream::buffer::int_type crc_ostream::buffer::overflow(int_type ch) {
+  sync_crc();
+  if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+    *pptr() = traits_type::to_char_type(ch);
+    pbump(1);
+  }
+  return traits_type::not_eof(ch);
+}
+
+std::streamsize crc_ostream::buffer::xsputn(const char *s, std::streamsize n) {
+  // large writes bypass the buffer
+  if (n >= (std::streamsize)sizeof(buf)) {
+    sync_crc();
+    crc = crc128_update(crc, s, n);
+    return n;
   }
-  return crc & 0xffffffffffffffff;
+  return std::streambuf::xsputn(s, n);
+}
+
+int crc_ostream::buffer::sync() {
+  sync_crc();
+  return 0;
+}
+
+crc128_t crc_ostream::buffer::hash() {
+  sync_crc();
+  return crc128_finalize(crc);
+}
+
+std::string to_string(crc128_t crc) {
+  char str[33];
+  snprintf(str, sizeof(str), "%016llx%016llx", (unsigned long long)crc.hi,
+           (unsigned long long)crc.lo);
+  return str;
+}
+
 }
@@ -11,10 +11,14 @@
  *  - ReflectIn     = True
  *  - XorOut        = 0x0000000000000000
  *  - ReflectOut    = True
- *  - Algorithm     = table-driven
+ *  - Algorithm     = table-driven (slicing-by-8)
  *
  * This file defines the functions crc_init(), crc_update() and crc_finalize().
  *
+ * It also defines a 128-bit variant (crc128_*) that runs the CRC above and
+ * CRC-64/XZ (ECMA-182 polynomial) side by side, for hashing large inputs,
+ * like printed functions, with a low probability of collisions.
+ *
  * The crc_init() function returns the initial \c crc value and must be called
  * before the first call to crc_update().
  * Similarly, the crc_finalize() function must be called after the last call
@@ -91,8 +95,89 @@ static inline crc_t crc_finalize(crc_t crc) {
   return crc;
 }
 
+
+/**
+ * The type of the 128-bit CRC values.
+ */
+typedef struct {
+  uint64_t lo; /* CRC-64 with the polynomial above */
+  uint64_t hi; /* CRC-64/XZ */
+} crc128_t;
+
+/**
+ * Calculate the initial 128-bit crc value.
+ *
+ * \return     The initial crc value.
+ */
+static inline crc128_t crc128_init(void) {
+  crc128_t crc = { 0, 0xffffffffffffffff };
+  return crc;
+}
+
+/**
+ * Update the 128-bit crc value with new data.
+ *
+ * \param[in] crc      The current crc value.
+ * \param[in] data     Pointer to a buffer of \a data_len bytes.
+ * \param[in] data_len Number of bytes in the \a data buffer.
+ * \return             The updated crc value.
+ */
+crc128_t crc128_update(crc128_t crc, const void *data, size_t data_len);
+
+/**
+ * Calculate the final 128-bit crc value.
+ *
+ * \param[in] crc  The current crc value.
+ * \return     The final crc value.
+ */
+static inline crc128_t crc128_finalize(crc128_t crc) {
+  crc.hi ^= 0xffffffffffffffff;
+  return crc;
+}
+
+static inline int crc128_equal(crc128_t a, crc128_t b) {
+  return a.lo == b.lo && a.hi == b.hi;
+}
+
 #ifdef __cplusplus
 } /* closing brace for extern "C" */
+
+#include <ostream>
+#include <streambuf>
+#include <string>
+
+namespace util {
+
+/**
+ * An output stream that computes the 128-bit crc of everything written to it
+ * without storing it, e.g., to hash a printed function.
+ */
+class crc_ostream : public std::ostream {
+  class buffer : public std::streambuf {
+    char buf[4096];
+    crc128_t crc = crc128_init();
+
+    void sync_crc();
+
+  protected:
+    int_type overflow(int_type ch) override;
+    std::streamsize xsputn(const char *s, std::streamsize n) override;
+    int sync() override;
+
+  public:
+    buffer();
+    crc128_t hash();
+  } buf;
+
+public:
+  crc_ostream() : std::ostream(&buf) {}
+  crc128_t hash() { return buf.hash(); }
+};
+
+/* hexadecimal representation of a crc, e.g., for cache keys */
+std::string to_string(crc128_t crc);
+
+}
 #endif
 
 #endif /* CRC_H */
@@ -42,6 +42,7 @@ public:
   }
 
   const auto& getResult() const { return ret_data; }
+  const auto& getGlobalResult() const { return glb_data; }
 };
 
 }
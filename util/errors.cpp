@@ -23,9 +23,13 @@ void Errors::add(const char *str, bool is_unsound) {
   add(string(str), is_unsound);
 }
 
-void Errors::add(string &&str, bool is_unsound) {
-  if (is_unsound)
+void Errors::add(string &&str, bool is_unsound, Details &&d) {
+  if (is_unsound) {
     errs.clear();
+    details.clear();
+  }
+  if (d)
+    details.emplace(str, std::move(d));
   errs.emplace(std::move(str), is_unsound);
 }
 
@@ -43,7 +47,10 @@ bool Errors::isUnsound() const {
 
 ostream& operator<<(ostream &os, const Errors &errs) {
   for (auto &[msg, unsound] : errs.errs) {
-    os << "ERROR: " << msg << '\n';
+    os << "ERROR: " << msg;
+    if (auto I = errs.details.find(msg); I != errs.details.end())
+      I->second(os);
+    os << '\n';
   }
   return os;
 }
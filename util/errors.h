@@ -3,6 +3,8 @@
 // Copyright (c) 2018-present The Alive2 Authors.
 // Distributed under the MIT license that can be found in the LICENSE file.
 
+#include <functional>
+#include <map>
 #include <ostream>
 #include <set>
 #include <string>
@@ -21,7 +23,15 @@ public:
 
 
 class Errors {
+public:
+  // Prints the details of an error (e.g., a counterexample) on demand.
+  // It may hold references to SMT state, so it must not be printed after
+  // the SMT context is reset.
+  using Details = std::function<void(std::ostream&)>;
+
+private:
   std::set<std::pair<std::string, bool>> errs;
+  std::map<std::string, Details> details;
 
 public:
   Errors() = default;
@@ -30,12 +40,15 @@ public:
   Errors(AliveException &&e);
 
   void add(const char *str, bool is_unsound);
-  void add(std::string &&str, bool is_unsound);
+  void add(std::string &&str, bool is_unsound, Details &&details = {});
   void add(AliveException &&e);
 
   explicit operator bool() const { return !errs.empty(); }
   bool isUnsound() const;
 
+  auto begin() const { return errs.begin(); }
+  auto end() const { return errs.end(); }
+
   friend std::ostream& operator<<(std::ostream &os, const Errors &e);
 };
 
@@ -0,0 +1,42 @@
+// Copyright (c) 2018-present The Alive2 Authors.
+// Distributed under the MIT license that can be found in the LICENSE file.
+
+#include "util/memusage.h"
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+namespace util {
+
+uint64_t get_rss() {
+#ifdef __linux__
+  // second field: resident pages
+  int fd = open("/proc/self/statm", O_RDONLY);
+  if (fd != -1) {
+    char buf[128];
+    auto n = read(fd, buf, sizeof(buf) - 1);
+    close(fd);
+    if (n > 0) {
+      buf[n] = '\0';
+      char *end;
+      strtoull(buf, &end, 10);
+      return strtoull(end, nullptr, 10) * sysconf(_SC_PAGESIZE);
+    }
+  }
+#endif
+  return get_peak_rss();
+}
+
+uint64_t get_peak_rss() {
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+#ifdef __APPLE__
+  return usage.ru_maxrss;
+#else
+  return usage.ru_maxrss * 1024ull;
+#endif
+}
+
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+// Copyright (c) 2018-present The Alive2 Authors.
+// Distributed under the MIT license that can be found in the LICENSE file.
+
+#include <cstdint>
+
+namespace util {
+
+// Resident set size of this process, in bytes
+uint64_t get_rss();
+
+// Peak resident set size of this process (and of its parent up to the fork,
+// for child processes), in bytes
+uint64_t get_peak_rss();
+
+}
@@ -3,18 +3,24 @@
 
 #include "util/parallel.h"
 #include "util/compiler.h"
+#include "util/stopwatch.h"
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <fcntl.h>
 #include <fstream>
+#include <optional>
 #include <regex>
 #include <sstream>
 #include <string>
+#include <sys/mman.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
 using namespace std;
 
+static constexpr size_t stage_page_size = 4096;
+
 void parallel::ensureParent() {
   assert(parent_pid != -1 && getpid() == parent_pid);
 }
@@ -32,12 +38,32 @@ bool parallel::init() {
     p.events = POLL_IN;
   }
   parent_pid = getpid();
+
+  // track the stages of the parent as well, as children inherit them
+  static char parent_stage[stage_page_size];
+  util::stage_breadcrumb(parent_stage, sizeof(parent_stage));
   return true;
 }
 
 void parallel::reapZombies() {
-  while (waitpid((pid_t)-1, nullptr, WNOHANG) > 0)
-    ;
+  pid_t pid;
+  int status;
+  while ((pid = waitpid((pid_t)-1, &status, WNOHANG)) > 0)
+    reaped(pid, status);
+}
+
+void parallel::reaped(pid_t pid, int status) {
+  auto I = find_if(children.rbegin(), children.rend(),
+                   [&](auto &c) { return c.pid == pid; });
+  if (I == children.rend() || !I->stage)
+    return;
+
+  if (WIFSIGNALED(status))
+    I->output << "ERROR: Worker process killed by signal " << WTERMSIG(status)
+              << " in stage: " << I->stage << "\n\n";
+
+  ENSURE(munmap(I->stage, stage_page_size) == 0);
+  I->stage = nullptr;
 }
 
 std::tuple<pid_t, std::ostream *, int> parallel::limitedFork() {
@@ -54,12 +80,18 @@ std::tuple<pid_t, std::ostream *, int> parallel::limitedFork() {
    * however, we'll need to block while there are too many outstanding
    * child processes
    */
-  while (active_children >= max_active_children) {
-    readFromChildren(/*blocking=*/true);
-    reapZombies();
+  if (active_children >= max_active_children) {
+    util::ScopedStage stage("wait for children");
+    while (active_children >= max_active_children) {
+      readFromChildren(/*blocking=*/true);
+      reapZombies();
+    }
   }
 
-  getToken();
+  {
+    util::ScopedStage stage("wait for token");
+    getToken();
+  }
 
   int index = children.size();
   children.emplace_back();
@@ -69,8 +101,10 @@ std::tuple<pid_t, std::ostream *, int> parallel::limitedFork() {
    * amortize cost of copying part of the output stringstream to a new
    * one by not doing this all that often
    */
-  if (index % 100 == 0)
+  if (index % 100 == 0) {
+    util::ScopedStage stage("emit output");
     emitOutput();
+  }
 
   out_file.flush();
 
@@ -78,12 +112,20 @@ std::tuple<pid_t, std::ostream *, int> parallel::limitedFork() {
   if (pipe(newKid.pipe) < 0)
     return {-1, nullptr, -1};
 
+  void *page = mmap(nullptr, stage_page_size, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (page != MAP_FAILED)
+    newKid.stage = (char*)page;
+
   std::fflush(nullptr);
+  optional<util::ScopedStage> stage(in_place, "fork");
   pid_t pid = fork();
   if (pid == (pid_t)-1)
     return {-1, nullptr, -1};
 
   if (pid == 0) {
+    // the parent records the fork
+    stage->cancel();
     /*
      * child -- we inherited the read ends of potentially many pipes;
      * close all of the open ones (including the new one)
@@ -92,6 +134,8 @@ std::tuple<pid_t, std::ostream *, int> parallel::limitedFork() {
       if (!c.eof)
         ENSURE(close(c.pipe[0]) == 0);
     fd_to_parent = newKid.pipe[1];
+    if (newKid.stage)
+      util::stage_breadcrumb(newKid.stage, stage_page_size);
   } else {
     /*
      * parent -- close the write side of the new pipe
@@ -190,6 +234,7 @@ void parallel::finishChild(bool is_timeout) {
     const char *msg = "ERROR: Timeout asynchronous\n\n";
     safe_write(fd_to_parent, msg, std::strlen(msg));
   } else {
+    util::ScopedStage stage("send output");
     childProcess &me = children.back();
     auto data = std::move(me.output).str();
     auto size = data.size();
@@ -199,11 +244,17 @@ void parallel::finishChild(bool is_timeout) {
 
 void parallel::finishParent() {
   ensureParent();
-  while (readFromChildren(/*blocking=*/true))
-    reapZombies();
-  assert(active_children == 0);
-  while (wait(nullptr) != -1)
-    ;
+  {
+    util::ScopedStage stage("wait for children");
+    while (readFromChildren(/*blocking=*/true))
+      reapZombies();
+    assert(active_children == 0);
+    pid_t pid;
+    int status;
+    while ((pid = wait(&status)) != -1)
+      reaped(pid, status);
+  }
+  util::ScopedStage stage("emit output");
   ENSURE(emitOutput());
 }
 
@@ -219,7 +270,8 @@ bool parallel::emitOutput() {
     if (std::regex_match(line, sm, rgx)) {
       assert(sm.size() == 2);
       int index = std::stoi(*std::next(sm.begin()));
-      if (children[index].eof) {
+      // wait until the child is reaped, as we may need to report its death
+      if (children[index].eof && !children[index].stage) {
         out_file << std::move(children[index].output).str();
         stringstream().swap(children[index].output); // free the RAM
       } else {
@@ -21,6 +21,11 @@ struct childProcess {
    */
   std::stringstream output;
   bool eof = false;
+  /*
+   * page shared with the child, where it keeps the stage it is in, so we
+   * can report where it died if it gets killed (e.g., out of memory)
+   */
+  char *stage = nullptr;
 };
 
 class parallel {
@@ -36,6 +41,7 @@ class parallel {
   void ensureParent();
   void ensureChild();
   void reapZombies();
+  void reaped(pid_t pid, int status);
   bool emitOutput();
   bool readFromChildren(bool blocking);
 
@@ -2,8 +2,15 @@
 // Distributed under the MIT license that can be found in the LICENSE file.
 
 #include "util/stopwatch.h"
+#include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <fcntl.h>
 #include <iomanip>
+#include <string>
+#include <unistd.h>
+#include <unordered_map>
+#include <vector>
 
 using namespace std;
 using namespace std::chrono;
@@ -42,4 +49,177 @@ ScopedWatch::~ScopedWatch() {
   callback(sw);
 }
 
+
+namespace {
+struct Frame {
+  size_t parent_path_len;
+  steady_clock::duration children{0};
+};
+
+bool stages_enabled = false;
+string stages_file;
+string stage_path;
+vector<Frame> stage_stack;
+unordered_map<string, steady_clock::duration> stage_times;
+
+string trace_file;
+string trace_buffer;
+
+char *breadcrumb = nullptr;
+size_t breadcrumb_size = 0;
+
+void update_breadcrumb() {
+  if (!breadcrumb)
+    return;
+  auto n = min(stage_path.size(), breadcrumb_size - 1);
+  memcpy(breadcrumb, stage_path.data(), n);
+  breadcrumb[n] = '\0';
+}
+constexpr size_t trace_flush_threshold = 64 * 1024;
+
+// a single append, as parallel workers share the files
+void append_to_file(const string &file, const string &buf) {
+  int fd = open(file.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+  if (fd == -1)
+    return;
+  const char *ptr = buf.data();
+  size_t size = buf.size();
+  while (size > 0) {
+    auto n = write(fd, ptr, size);
+    if (n <= 0)
+      break;
+    ptr  += n;
+    size -= n;
+  }
+  close(fd);
+}
+
+void json_escape(string &out, string_view str) {
+  for (char c : str) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += c;
+    } else if ((unsigned char)c >= 0x20) {
+      out += c;
+    }
+  }
+}
+
+void trace_flush() {
+  if (trace_buffer.empty())
+    return;
+  append_to_file(trace_file, trace_buffer);
+  trace_buffer.clear();
+}
+
+void trace_event(string_view name, steady_clock::time_point start,
+                 steady_clock::duration elapsed) {
+  auto us = [](auto d) { return duration_cast<microseconds>(d).count(); };
+  auto &out = trace_buffer;
+  out += "{\"name\":\"";
+  json_escape(out, name);
+  out += "\",\"ph\":\"X\",\"pid\":" + to_string(getpid()) +
+         ",\"tid\":0,\"ts\":" + to_string(us(start.time_since_epoch())) +
+         ",\"dur\":" + to_string(us(elapsed)) + ",\"args\":{\"stack\":\"";
+  json_escape(out, stage_path);
+  out += "\"}},\n";
+
+  if (trace_buffer.size() >= trace_flush_threshold)
+    trace_flush();
+}
+}
+
+ScopedStage::ScopedStage(string_view name)
+  : active(stages_enabled || !trace_file.empty() || breadcrumb) {
+  if (!active)
+    return;
+
+  stage_stack.push_back({ stage_path.size() });
+  if (!stage_path.empty())
+    stage_path += ';';
+  // ';' separates frames and '\n' records in the folded format
+  for (char c : name) {
+    stage_path += c == ';' ? ':' : (c == '\n' ? ' ' : c);
+  }
+  update_breadcrumb();
+  start = now();
+}
+
+ScopedStage::~ScopedStage() {
+  if (!active)
+    return;
+
+  auto elapsed = now() - start;
+  auto &frame = stage_stack.back();
+  if (stages_enabled)
+    stage_times[stage_path] += elapsed - frame.children;
+  if (!trace_file.empty()) {
+    auto name_start = frame.parent_path_len + (frame.parent_path_len != 0);
+    trace_event(string_view(stage_path).substr(name_start), start, elapsed);
+  }
+  stage_path.resize(frame.parent_path_len);
+  stage_stack.pop_back();
+  if (!stage_stack.empty())
+    stage_stack.back().children += elapsed;
+  update_breadcrumb();
+}
+
+void ScopedStage::cancel() {
+  if (!active)
+    return;
+  stage_path.resize(stage_stack.back().parent_path_len);
+  stage_stack.pop_back();
+  active = false;
+  update_breadcrumb();
+}
+
+void stage_times_enable(const char *filename) {
+  stages_enabled = true;
+  stages_file = filename;
+}
+
+bool stage_times_enabled() {
+  return stages_enabled;
+}
+
+void stage_times_flush() {
+  trace_flush();
+
+  if (!stages_enabled || stage_times.empty())
+    return;
+
+  string buf;
+  for (auto &[path, time] : stage_times) {
+    auto us = duration_cast<microseconds>(time).count();
+    if (us > 0)
+      buf += path + ' ' + to_string(us) + '\n';
+  }
+  stage_times.clear();
+  append_to_file(stages_file, buf);
+}
+
+void stage_times_clear() {
+  stage_times.clear();
+  trace_buffer.clear();
+}
+
+void stage_breadcrumb(char *buffer, size_t size) {
+  breadcrumb = buffer;
+  breadcrumb_size = size;
+  update_breadcrumb();
+}
+
+bool trace_enable(const char *filename) {
+  trace_file = filename;
+
+  // The trace is a JSON array of events in the Chrome trace event format,
+  // which allows the closing bracket to be missing. The first process to
+  // get here creates the file with the opening bracket atomically.
+  string tmp = trace_file + '.' + to_string(getpid());
+  append_to_file(tmp, "[\n");
+  bool created = link(tmp.c_str(), trace_file.c_str()) == 0;
+  unlink(tmp.c_str());
+  return created || access(trace_file.c_str(), W_OK) == 0;
+}
+
 }
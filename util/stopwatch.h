@@ -6,6 +6,7 @@
 #include <chrono>
 #include <ostream>
 #include <functional>
+#include <string_view>
 
 namespace util {
 
@@ -33,4 +34,37 @@ public:
   ~ScopedWatch();
 };
 
+
+// Accounts the time spent in a verification stage. Stages nest, and the
+// self time of a stage is accumulated under the path of the open stages,
+// e.g., "pass;fn;vcgen;src". Does nothing unless enabled.
+class ScopedStage {
+  std::chrono::steady_clock::time_point start;
+  bool active;
+
+public:
+  explicit ScopedStage(std::string_view name);
+  ~ScopedStage();
+  // close the stage without accounting for it
+  void cancel();
+};
+
+// Appends the accumulated stage times to the given file on flush, in the
+// folded stacks format used by flamegraph.pl.
+void stage_times_enable(const char *filename);
+bool stage_times_enabled();
+void stage_times_flush();
+// forget the times accumulated so far, e.g., those inherited from the parent
+// process after a fork
+void stage_times_clear();
+
+// Also record each stage as a trace event (Chrome trace event format, which
+// Perfetto and chrome://tracing read). Events are appended to the file on
+// stage_times_flush(), so processes running in parallel share a timeline.
+bool trace_enable(const char *filename);
+
+// Keep the path of the open stages, NUL-terminated, in the given buffer, so
+// that it can be read if the process dies (e.g., from shared memory).
+void stage_breadcrumb(char *buffer, size_t size);
+
 }